@@ -120,6 +120,17 @@ def isentropic_A_on_Astar(M, y):
     n = 0.5*(y + 1)/(y - 1)
     return (2/(y + 1.0) + M*M/n/2)**n / M
 
+def isentropic_M_from_A_on_Astar(A_on_Astar, y):
+    # supersonic branch, A/A* is monotonic there so just bisect.
+    lo = np.ones_like(A_on_Astar)
+    hi = np.full_like(A_on_Astar, 20.0)
+    for _ in range(60):
+        mid = 0.5*(lo + hi)
+        under = isentropic_A_on_Astar(mid, y) < A_on_Astar
+        lo = np.where(under, mid, lo)
+        hi = np.where(under, hi, mid)
+    return 0.5*(lo + hi)
+
 def cea_AEAT_for(P, ofr, M_lerp_1_to_exit):
     P_exit = 101325.0
     gamma_tht = CEA["t_gamma"](P, ofr, 1.0)
@@ -139,6 +150,22 @@ def cea(name, P, ofr):
         AEAT = cea_AEAT_for(P, ofr, 1.0)
     return CEA[name](P, ofr, AEAT)
 
+def cea3(name, P, ofr, AEAT):
+    # as `cea`, but for an arbitrary (exit) expansion ratio rather than the
+    # ideal sea-level one.
+    frac = 1.0
+    if name.startswith("lowm_"):
+        frac = CEA_M_lowm
+        name = name[len("lowm_"):]
+    elif name.startswith("midm_"):
+        frac = CEA_M_midm
+        name = name[len("midm_"):]
+    if frac != 1.0:
+        gamma_tht = CEA["t_gamma"](P, ofr, 1.0)
+        M_exit = isentropic_M_from_A_on_Astar(AEAT, gamma_tht)
+        AEAT = isentropic_A_on_Astar(1 + (M_exit - 1)*frac, gamma_tht)
+    return CEA[name](P, ofr, AEAT)
+
 def getattr_cea(cea_result, name):
     if name == "c_mach":
         return 0.0
@@ -147,13 +174,18 @@ def getattr_cea(cea_result, name):
     return getattr(cea_result, name)
 
 LUT_FOR_ALL = True
+# Interpolation used by the LUTs, either "bilinear" or "catmullrom". The bicubic
+# catmull-rom tables reach the same error with a fraction of the entries, but the
+# c lookups are all bilinear so they are only reported on (never written).
+LUT_KERNEL = "bilinear"
+LUT_SIZES = {"bilinear": (80, 80), "catmullrom": (24, 24)}
 
 def find_approximation(get_surf, type_name, var_name, pidxs=None,
         qidxs=None, rel_only=False, points=200, spacing=1.25, max_error=0.015,
         blitz=2.0, lut=None, extra_reqs=()):
 
     if LUT_FOR_ALL:
-        lut = (80, 80)
+        lut = LUT_SIZES[LUT_KERNEL]
 
     def wrapped(what=""):
         if what != "get":
@@ -167,7 +199,8 @@ def find_approximation(get_surf, type_name, var_name, pidxs=None,
                 spacing=spacing
             )
         if lut is not None:
-            tbl = JustGimmeATable(surf, f"{type_name.lower()}_{var_name}", *lut)
+            tbl = JustGimmeATable(surf, f"{type_name.lower()}_{var_name}", *lut,
+                    kernel=LUT_KERNEL)
 
         evaluator = evaluator_rel_only if rel_only else evaluator_abs_only
 
@@ -282,6 +315,46 @@ find_cea_Pr_exit = cea_approximation("Pr_exit", "pran",
         lut=(10, 60))
 
 
+# Altitude tables, which are additionally over the expansion ratio. Only the
+# properties past the throat depend on it. Note these are optional for the c,
+# and must be generated as a complete set.
+LUT_SIZE_3D = (40, 40, 24)
+CEA_AEAT_BOUNDS = (2.0, 12.0) # matches the nozzle limits in c/contour.c.
+
+def cea3_approximation(our_name, cea_name, extra_reqs=()):
+    f = lambda P, ofr, AEAT: cea3(cea_name, P, ofr, AEAT)
+    def wrapped(what=""):
+        if what != "approximate":
+            assert False, f"invalid what: {what}"
+        print(f"approximating CEA {our_name} (over AEAT)")
+        tbl = JustGimmeACube(f, f"cea3_{our_name}",
+                (1.0, 5.0, 1.0, 3.0, *CEA_AEAT_BOUNDS), LUT_SIZE_3D)
+        tbl.run(extra_reqs=extra_reqs)
+    return wrapped
+
+find_cea3_Isp = cea3_approximation("Isp", "isp")
+find_cea3_gamma_lowm = cea3_approximation("gamma_lowm", "lowm_gamma",
+        extra_reqs=[f"'M_midm' as: lerp(1, M_exit, {CEA_M_lowm})"])
+find_cea3_gamma_midm = cea3_approximation("gamma_midm", "midm_gamma",
+        extra_reqs=[f"'M_midm' as: lerp(1, M_exit, {CEA_M_midm})"])
+find_cea3_gamma_exit = cea3_approximation("gamma_exit", "gamma")
+find_cea3_cp_lowm = cea3_approximation("cp_lowm", "lowm_cp",
+        extra_reqs=[f"'M_midm' as: lerp(1, M_exit, {CEA_M_lowm})"])
+find_cea3_cp_midm = cea3_approximation("cp_midm", "midm_cp",
+        extra_reqs=[f"'M_midm' as: lerp(1, M_exit, {CEA_M_midm})"])
+find_cea3_cp_exit = cea3_approximation("cp_exit", "cp")
+find_cea3_mu_lowm = cea3_approximation("mu_lowm", "lowm_visc",
+        extra_reqs=[f"'M_midm' as: lerp(1, M_exit, {CEA_M_lowm})"])
+find_cea3_mu_midm = cea3_approximation("mu_midm", "midm_visc",
+        extra_reqs=[f"'M_midm' as: lerp(1, M_exit, {CEA_M_midm})"])
+find_cea3_mu_exit = cea3_approximation("mu_exit", "visc")
+find_cea3_Pr_lowm = cea3_approximation("Pr_lowm", "lowm_pran",
+        extra_reqs=[f"'M_midm' as: lerp(1, M_exit, {CEA_M_lowm})"])
+find_cea3_Pr_midm = cea3_approximation("Pr_midm", "midm_pran",
+        extra_reqs=[f"'M_midm' as: lerp(1, M_exit, {CEA_M_midm})"])
+find_cea3_Pr_exit = cea3_approximation("Pr_exit", "pran")
+
+
 @Masker
 def ipa_masker(T, P):
     # Psat check is way worse. thermo.Chemical is pretty shithouse.
@@ -588,13 +661,64 @@ def check_cea_Pr_along():
 
 
 
+def friction_factor_colebrook(Re, rr):
+    # Mirrors `friction_factor_colebrook` in c/relations.c, but converged hard.
+    x = -1.8*np.log10((rr/3.7)**1.11 + 6.9/Re) # haaland guess.
+    for _ in range(100):
+        x = -2*np.log10(rr/3.71 + 2.52*x/Re)
+    return 1/x**2
+def friction_factor_serghides(Re, rr):
+    A = -2*np.log10(rr/3.71 + 12/Re)
+    B = -2*np.log10(rr/3.71 + 2.52*A/Re)
+    C = -2*np.log10(rr/3.71 + 2.52*B/Re)
+    return 1/(A - (B - A)**2/(C - 2*B + A))**2
+def friction_factor_goudar_sonnad(Re, rr):
+    a = 2/np.log(10)
+    b = rr/3.71
+    d = np.log(10)*Re/(2*2.52)
+    s = b*d + np.log(d)
+    q = s**(s/(s + 1))
+    g = b*d + np.log(d/q)
+    z = np.log(q/g)
+    dLA = z*g/(g + 1)
+    dCFA = dLA*(1 + z/2/((g + 1)**2 + z/3*(2*g - 1)))
+    return 1/(a*(np.log(d/q) + dCFA))**2
+
+def check_friction_factors():
+    # Explicit correlations the c can use instead of iterating colebrook, over
+    # the range of coolant channel flows we see.
+    Re = np.geomspace(2.5e3, 1e6, 300)
+    rr = np.geomspace(1e-5, 0.2, 300) # eps/D
+    Re, rr = np.meshgrid(Re, rr, indexing="ij")
+    actual = friction_factor_colebrook(Re, rr)
+    fig, axes = summary_2D.window.new_plots(cols=2,
+            title="friction factor vs colebrook")
+    for ax, (name, f) in zip(axes, [
+                ("serghides", friction_factor_serghides),
+                ("goudar-sonnad", friction_factor_goudar_sonnad),
+            ]):
+        relerr = np.abs(rel_error(actual, f(Re, rr)))
+        print(f"friction factor {name}: max rel error vs colebrook "
+              f"{np.nanmax(relerr)*100:.3g}%")
+        cont = ax.contourf(np.log10(Re), np.log10(rr), 100*relerr, levels=300,
+                cmap="viridis")
+        fig.colorbar(cont, ax=ax)
+        ax.set_title(f"{name} rel error (log10 Re, log10 eps/D)")
+        ax.set_grid("none")
+
+
+
+
 class JustGimmeATable:
     # holy balls some are hard. just gimme a lookuptable.
 
-    def __init__(self, surf, name, size_P, size_ofr):
+    def __init__(self, surf, name, size_P, size_ofr, kernel="bilinear"):
+        if kernel not in LUT_SIZES:
+            raise ValueError(f"unrecognised kernel: {repr(kernel)}")
         self.surf = surf
         self.name = name
         self.shape = (size_P, size_ofr)
+        self.kernel = kernel
         X = np.linspace(surf.xlo, surf.xhi, size_P)
         Y = np.linspace(surf.ylo, surf.yhi, size_ofr)
         X, Y = np.meshgrid(X, Y, indexing="ij")
@@ -604,8 +728,14 @@ class JustGimmeATable:
             Y[~mask] = np.nan
         self.tbl = surf.f(X, Y)
         self.tbl = self.tbl.flatten("C") # rowmajor.
-
-    def __call__(self, x, y):
+        # The c stores tables as f32 (interpolating in f64), so evaluate with the
+        # same rounding. Keep the exact values to report what that costs.
+        self.tbl_exact = self.tbl
+        self.tbl = self.tbl.astype(np.float32).astype(np.float64)
+
+    def __call__(self, x, y, exact=False):
+        # Mirrors `lut_bilinear` and `lut_catmullrom` in c/lut.c.
+        tbl = self.tbl_exact if exact else self.tbl
         xlo, xhi, ylo, yhi = self.surf.bounds()
         x = (x - xlo) / (xhi - xlo)
         x *= self.shape[0] - 1
@@ -619,13 +749,38 @@ class JustGimmeATable:
         j = np.maximum(j, 0)
         j = np.minimum(j, self.shape[1] - 2)
         s = y - j
-        c00 = self.tbl[i*self.shape[1] + j]
-        c01 = self.tbl[i*self.shape[1] + j + 1]
-        c10 = self.tbl[(i + 1)*self.shape[1] + j]
-        c11 = self.tbl[(i + 1)*self.shape[1] + j + 1]
+        c00 = tbl[i*self.shape[1] + j]
+        c01 = tbl[i*self.shape[1] + j + 1]
+        c10 = tbl[(i + 1)*self.shape[1] + j]
+        c11 = tbl[(i + 1)*self.shape[1] + j + 1]
         c0 = c00 + s*(c01 - c00)
         c1 = c10 + s*(c11 - c10)
-        return c0 + t*(c1 - c0)
+        bilinear = c0 + t*(c1 - c0)
+        if self.kernel == "bilinear":
+            return bilinear
+
+        def catmullrom(p0, p1, p2, p3, t):
+            a = p2 - p0
+            b = 2*p0 - 5*p1 + 4*p2 - p3
+            c = 3*(p1 - p2) + p3 - p0
+            return p1 + 0.5*t*(a + t*(b + t*c))
+        def row(i):
+            at = lambda j: tbl[i*self.shape[1] + np.clip(j, 0,
+                    self.shape[1] - 1)]
+            p1 = at(j)
+            p2 = at(j + 1)
+            # linearly extrapolate past the edges.
+            p0 = np.where(j > 0, at(j - 1), 2*p1 - p2)
+            p3 = np.where(j + 2 < self.shape[1], at(j + 2), 2*p2 - p1)
+            return catmullrom(p0, p1, p2, p3, s)
+        clip = lambda i: np.clip(i, 0, self.shape[0] - 1)
+        q1 = row(i)
+        q2 = row(i + 1)
+        q0 = np.where(i > 0, row(clip(i - 1)), 2*q1 - q2)
+        q3 = np.where(i + 2 < self.shape[0], row(clip(i + 2)), 2*q2 - q1)
+        v = catmullrom(q0, q1, q2, q3, t)
+        # stencils touching masked entries fall back to bilinear.
+        return np.where(np.isnan(v), bilinear, v)
 
     def run(self, extra_reqs=()):
         lines = []
@@ -642,6 +797,14 @@ class JustGimmeATable:
         abserr = np.abs(abs_error(values, approx))
         relerr = np.abs(rel_error(values, approx))
 
+        exact = self(X, Y, exact=True)
+        exact[mask] = np.nan
+        f32abserr = np.abs(abs_error(exact, approx))
+        f32relerr = np.abs(rel_error(exact, approx))
+        print(f"{self.name}: f32 storage adds at most "
+              f"abs {np.nanmax(f32abserr)*100:.3g}%, "
+              f"rel {np.nanmax(f32relerr)*100:.3g}%")
+
         fig, axes = summary_2D.window.new_plots(rows=2, cols=2,
                 title=f"LUT {self.name}")
         cont = axes[0,0].contourf(X, Y, values, levels=300, cmap="viridis")
@@ -662,30 +825,45 @@ class JustGimmeATable:
         axes[1,1].set_grid("none")
 
 
-        lines.extend([
-            f"    /* evenly-spaced flattened (C-ordered) 2D LUT */",
-            f"    /* max error of: */",
-            f"    /*   abs {np.nanmax(abserr)*100:.3g}% */",
-            f"    /*   rel {np.nanmax(relerr)*100:.3g}% */",
-        ])
+        if self.kernel != "bilinear":
+            # Compare against what the default tables would achieve, since the
+            # compact ones are only worth it if they are no worse.
+            ref = JustGimmeATable(self.surf, self.name, *LUT_SIZES["bilinear"])
+            refapprox = ref(X, Y)
+            refapprox[mask] = np.nan
+            refabserr = np.abs(abs_error(values, refapprox))
+            refrelerr = np.abs(rel_error(values, refapprox))
+            worse = (np.nanmax(abserr) > np.nanmax(refabserr)
+                  or np.nanmax(relerr) > np.nanmax(refrelerr))
+            print(f"{self.name}: {rows}x{cols} {self.kernel} vs "
+                  f"{ref.shape[0]}x{ref.shape[1]} bilinear: "
+                  f"abs {np.nanmax(abserr)*100:.3g}% vs "
+                  f"{np.nanmax(refabserr)*100:.3g}%, "
+                  f"rel {np.nanmax(relerr)*100:.3g}% vs "
+                  f"{np.nanmax(refrelerr)*100:.3g}%"
+                  + (" (WORSE, increase the size)" if worse else ""))
+            return
+
+        # Bounds, shape and error all live in the table file itself (which
+        # `bruv.build` packs for the c to load), so only the lookup is needed.
         if extra_reqs:
             lines.append(f"    /* also requires: */")
             for x in extra_reqs:
                 lines.append(f"    /*   {x} */")
-        lines.append(f"    const f64 XLO = {xlo};")
-        lines.append(f"    const f64 XHI = {xhi};")
-        lines.append(f"    const f64 YLO = {ylo};")
-        lines.append(f"    const f64 YHI = {yhi};")
-        lines.append(f"    enum {{ XLEN = {rows},")
-        lines.append(f"           YLEN = {cols}, }};")
-        lines.append(f"    #include \"tbl/{self.name}.i\"")
+        lookup = self.name.split("_")[0].upper() + "_2DLOOKUP"
+        lines.append(f"    {lookup}({self.name});")
         lines.append(f"")
 
         print("\n".join(lines))
 
         # now write the table tile.
         lines = [
-            f"/* LUT for {self.name} */"
+            f"/* LUT for {self.name} */",
+            f"/* x: [{xlo}, {xhi}] */",
+            f"/* y: [{ylo}, {yhi}] */",
+            f"/* shape: {rows}x{cols} */",
+            f"/* max error of: abs {np.nanmax(abserr)*100:.3g}%, "
+                f"rel {np.nanmax(relerr)*100:.3g}% */",
         ]
         lines.append(f"static const f32 tbl[{rows * cols}] = {{")
 
@@ -720,6 +898,93 @@ class JustGimmeATable:
 
 
 
+class JustGimmeACube:
+    # JustGimmeATable but 3D, for the altitude tables. No masking, cea is
+    # defined everywhere we care about.
+
+    def __init__(self, f, name, bounds, shape):
+        self.f = f
+        self.name = name
+        self.bounds = bounds
+        self.shape = shape
+        axes = [np.linspace(lo, hi, n) for lo, hi, n
+                in zip(bounds[0::2], bounds[1::2], shape)]
+        X, Y, Z = np.meshgrid(*axes, indexing="ij")
+        self.tbl = f(X, Y, Z).flatten("C") # rowmajor, z fastest.
+        self.tbl = self.tbl.astype(np.float32).astype(np.float64)
+
+    def __call__(self, x, y, z):
+        # Mirrors `lut_trilinear` in c/lut.c.
+        idx = []
+        frac = []
+        for v, lo, hi, n in zip((x, y, z), self.bounds[0::2], self.bounds[1::2],
+                self.shape):
+            v = (v - lo) / (hi - lo) * (n - 1)
+            i = np.clip(np.floor(v).astype(int), 0, n - 2)
+            idx.append(i)
+            frac.append(v - i)
+        (i, j, k), (t, s, r) = idx, frac
+        _, ylen, zlen = self.shape
+        at = lambda i, j, k: self.tbl[(i*ylen + j)*zlen + k]
+        lerp = lambda a, b, t: a + t*(b - a)
+        c00 = lerp(at(i, j, k), at(i, j, k + 1), r)
+        c01 = lerp(at(i, j + 1, k), at(i, j + 1, k + 1), r)
+        c10 = lerp(at(i + 1, j, k), at(i + 1, j, k + 1), r)
+        c11 = lerp(at(i + 1, j + 1, k), at(i + 1, j + 1, k + 1), r)
+        return lerp(lerp(c00, c01, s), lerp(c10, c11, s), t)
+
+    def run(self, extra_reqs=()):
+        xlo, xhi, ylo, yhi, zlo, zhi = self.bounds
+        rows, cols, deps = self.shape
+
+        # too many cea evaluations to sweep a grid, so spot check.
+        rng = np.random.default_rng(1)
+        X = rng.uniform(xlo, xhi, 20000)
+        Y = rng.uniform(ylo, yhi, 20000)
+        Z = rng.uniform(zlo, zhi, 20000)
+        values = self.f(X, Y, Z)
+        approx = self(X, Y, Z)
+        abserr = np.abs(abs_error(values, approx))
+        relerr = np.abs(rel_error(values, approx))
+
+        lines = []
+        if extra_reqs:
+            lines.append(f"    /* also requires: */")
+            for x in extra_reqs:
+                lines.append(f"    /*   {x} */")
+        lines.append(f"    CEA_EXPANDED_LOOKUP({self.name[len('cea3_'):]});")
+        lines.append(f"")
+        print("\n".join(lines))
+
+        lines = [
+            f"/* LUT for {self.name} */",
+            f"/* x: [{xlo}, {xhi}] */",
+            f"/* y: [{ylo}, {yhi}] */",
+            f"/* z: [{zlo}, {zhi}] */",
+            f"/* shape: {rows}x{cols}x{deps} */",
+            f"/* max error of: abs {np.nanmax(abserr)*100:.3g}%, "
+                f"rel {np.nanmax(relerr)*100:.3g}% */",
+        ]
+        lines.append(f"static const f32 tbl[{rows * cols * deps}] = {{")
+        entrylen = 17
+        display_cols = (80 - 4) // entrylen
+        for start in range(0, len(self.tbl), display_cols):
+            chunk = self.tbl[start:start + display_cols]
+            entries = [f"{val:.8e}f," if val == val else "fNAN,"
+                       for val in chunk]
+            lines.append(" "*4 + "".join(e.ljust(entrylen) for e in entries))
+        lines.append(f"}};")
+        lines.append(f"")
+
+        paths.APPROXIMATOR_TBLS.mkdir(parents=True, exist_ok=True)
+        with open(paths.APPROXIMATOR_TBLS / f"{self.name}.i", "w") as f:
+            f.write("\n".join(lines))
+
+
+
+
+
+
 def _run():
     find_cea_Isp(what="approximate")
 
@@ -752,6 +1017,20 @@ def _run():
     find_cea_Pr_midm(what="approximate")
     find_cea_Pr_exit(what="approximate")
 
+    find_cea3_Isp(what="approximate")
+    find_cea3_gamma_lowm(what="approximate")
+    find_cea3_gamma_midm(what="approximate")
+    find_cea3_gamma_exit(what="approximate")
+    find_cea3_cp_lowm(what="approximate")
+    find_cea3_cp_midm(what="approximate")
+    find_cea3_cp_exit(what="approximate")
+    find_cea3_mu_lowm(what="approximate")
+    find_cea3_mu_midm(what="approximate")
+    find_cea3_mu_exit(what="approximate")
+    find_cea3_Pr_lowm(what="approximate")
+    find_cea3_Pr_midm(what="approximate")
+    find_cea3_Pr_exit(what="approximate")
+
     check_cea_gamma_along()
     check_cea_cp_along()
     check_cea_mu_along()
@@ -767,6 +1046,8 @@ def _run():
     find_ethanol_mu(what="approximate")
     find_ethanol_k(what="approximate")
 
+    check_friction_factors()
+
 
 
 def run(view=True, save=False):
@@ -44,6 +44,13 @@ def _load_bridge():
     sys.modules[name] = module
     spec.loader.exec_module(module)
 
+    # Hand over the property tables before anything can execute.
+    if not paths.C_TABLES.is_file():
+        raise ImportError(f"property tables not found, {howtobuild}")
+    err = module.load_tables(str(paths.C_TABLES.resolve()))
+    if err is not None:
+        raise ImportError(f"failed to load property tables: {err}")
+
     # Cache me.
     _bridge_module = module
     return _bridge_module
@@ -52,7 +59,7 @@ def _load_bridge():
 # Mimic the cythonised bridge:
 
 # The only symbols exported from the cython:
-__all__ = ["Interpretation", "State"]
+__all__ = ["Interpretation", "State", "Execution", "StateBatch"]
 
 def __getattr__(name):
     if name not in __all__:
@@ -69,5 +69,48 @@ typedef unsigned long long c_eight_bytes
 // Returns null on success, otherwise a string error message.
 C_EMIT const char* c_execute(c_eight_bytes* state, c_IH interpretation_hash);
 
+// Size of each state's error message from a batch.
+#define C_ERROR_SIZE (1024)
+
+// Executes the `count` state arrays stored back to back from `states`, spread
+// over `threads` threads (1 to run them all on the calling thread). States are
+// run in groups of up to four (sharing their coolant marches), and any group
+// which fails is re-run one state at a time, so only the erroneous states fail.
+// Each state's error message is written to its `C_ERROR_SIZE` chars of `errors`
+// (empty on success). Returns null if the batch was run, otherwise a string
+// error message (and no state was run).
+C_EMIT const char* c_execute_batch(c_eight_bytes* states, long long count,
+        c_IH interpretation_hash, long long threads, char* errors);
+
+// Progress of an execution, which other threads may watch (and cancel) while it
+// runs. Shared lock-free, so only ever access it via the functions below.
+typedef struct c_Progress {
+    long long iterations; // optimiser iterations begun (over every run).
+    long long evaluations; // cost evaluations completed.
+    double best_cost; // lowest cost evaluated (nan before any).
+    long long cancel; // non-zero once cancellation has been requested.
+} c_Progress;
+
+// Resets the given progress, ready for a new execution.
+C_EMIT void c_progress_reset(c_Progress* progress);
+
+// Copies a snapshot of the given (possibly running) progress into `out`.
+C_EMIT void c_progress_read(const c_Progress* progress, c_Progress* out);
+
+// Requests cancellation of the execution with the given progress, which stops
+// at its next cost evaluation (failing with an error). Note the final
+// simulation after optimisation is not interruptible.
+C_EMIT void c_progress_cancel(c_Progress* progress);
+
+// Equivalent to `c_execute`, but publishing to (and honouring cancellation of)
+// the given progress throughout. The progress must outlive the execution.
+C_EMIT const char* c_execute_watched(c_eight_bytes* state,
+        c_IH interpretation_hash, c_Progress* progress);
+
+// Loads the property tables from the given packed table file, which must happen
+// before any execution. Returns null on success, otherwise a string error
+// message.
+C_EMIT const char* c_load_tables(const char* path);
+
 
 #endif
@@ -25,11 +25,27 @@ cdef extern from "bridge.h":
     c_IH c_ih_append(c_IH running, const char* name, c_IHentry entry)
 
     ctypedef unsigned long long c_eight_bytes
-    const char* c_execute(c_eight_bytes* state, c_IH interpretation_hash)
-
-
+    const char* c_execute(c_eight_bytes* state, c_IH interpretation_hash) nogil
+    enum: C_ERROR_SIZE
+    const char* c_execute_batch(c_eight_bytes* states, long long count,
+            c_IH interpretation_hash, long long threads, char* errors) nogil
+    ctypedef struct c_Progress:
+        long long iterations
+        long long evaluations
+        double best_cost
+        long long cancel
+    void c_progress_reset(c_Progress* progress) nogil
+    void c_progress_read(const c_Progress* progress, c_Progress* out) nogil
+    void c_progress_cancel(c_Progress* progress) nogil
+    const char* c_execute_watched(c_eight_bytes* state,
+            c_IH interpretation_hash, c_Progress* progress) nogil
+    const char* c_load_tables(const char* path)
+
+
+from libc.stdint cimport uintptr_t
 from libc.stdlib cimport malloc, free
 from libc.string cimport memcpy, memset
+import threading
 import numpy as np
 cimport numpy as np
 np.import_array()
@@ -41,6 +57,20 @@ np.import_array()
 
 
 
+def load_tables(str path):
+    """
+    Loads the packed property tables at `path` into the c. Must be called before
+    any state is executed, however subsequent calls have no effect. Returns None
+    on success, otherwise a string detailing the error that occurred.
+    """
+    bytespath = path.encode("utf-8") # also owns the memory.
+    cdef const char* ret = c_load_tables(<const char*>bytespath)
+    if ret == NULL:
+        return None
+    return ret.decode("utf-8")
+
+
+
 cdef class Interpretation:
 
     F64 = C_F64
@@ -111,6 +141,12 @@ cdef class Interpretation:
         """
         self._finalised = 1
 
+    def names(Interpretation self):
+        """
+        Returns a list of every member name, in order.
+        """
+        return list(self._mapping.keys())
+
 
     # PRIVATE
 
@@ -146,6 +182,9 @@ cdef class State:
         `interp`.
         """
         self._array = NULL # in-case of throw
+        self._executing = 0
+        self._arenas = []
+        self._in_arena = set()
         if not interp._finalised:
             raise ValueError("requires finalised interpretation")
         self._array = <c_eight_bytes*>malloc(interp._length * 8)
@@ -192,6 +231,7 @@ cdef class State:
         if name not in self._interp._mapping:
             raise KeyError(f"missing name: {repr(name)}")
         idx, itype, _ = self._interp._mapping[name]
+        self._check_idle()
 
         cdef c_eight_bytes raw
         cdef double asfloat
@@ -231,27 +271,123 @@ cdef class State:
                 memcpy(&raw, &ptr, 8)
 
             # deallocate the previous array before updating.
-            free(<void*>self._array[idx])
-            self._array[idx] = <c_eight_bytes>0 # justin caseme.
+            self._detach(idx)
 
         self._set(idx, raw)
 
 
+    def arena(State self, list names, object count):
+        """
+        Points each array slot in `names` (which must all be of the same type)
+        at its own row of a single new block, each row holding `count` elements.
+        Returns the block as a zero-copy 2D numpy view, one row per name in the
+        given order. Rows are 64-byte aligned. The block is owned by this state,
+        so (as for `Buffer.view`) the view is only valid for the state's
+        lifetime. Setting one of these slots afterwards detaches it from the
+        block.
+        """
+        if type(count) is not int:
+            raise ValueError("expected integer count, got "
+                            f"{repr(type(count).__name__)}")
+        if count < 0:
+            raise ValueError(f"expected non-negative count, got {count}")
+        if not names:
+            raise ValueError("expected at least one name")
+        self._check_idle()
+        itype = None
+        idxs = []
+        for name in names:
+            if name not in self._interp._mapping:
+                raise KeyError(f"missing name: {repr(name)}")
+            idx, t, _ = self._interp._mapping[name]
+            if t == Interpretation.F64 or t == Interpretation.I64:
+                raise TypeError(f"not an array: {repr(name)}")
+            if itype is not None and t != itype:
+                raise TypeError(f"mismatched array type: {repr(name)}")
+            if idx in idxs:
+                raise ValueError(f"name repeated: {repr(name)}")
+            itype = t
+            idxs.append(idx)
+        dt = self._TO_DTYPE[itype]
+
+        # Pad each row to whole cache lines, and over-allocate to align the
+        # first.
+        cdef long long rowsize = ((count * dt.itemsize + 63) // 64) * 64
+        cdef long long totalsize = rowsize * len(idxs)
+        cdef void* raw = malloc(totalsize + 64)
+        if raw == NULL:
+            raise MemoryError()
+        self._arenas.append(<uintptr_t>raw)
+        cdef unsigned char* base = <unsigned char*>(
+                (<uintptr_t>raw + 63) & ~(<uintptr_t>63))
+        memset(base, 0, totalsize)
+
+        cdef Py_ssize_t i
+        cdef void* ptr
+        for i, idx in enumerate(idxs):
+            self._detach(idx)
+            ptr = <void*>(base + i*rowsize)
+            memcpy(&self._array[idx], &ptr, 8)
+            self._in_arena.add(idx)
+
+        if totalsize == 0:
+            return np.empty((len(idxs), 0), dtype=dt)
+        cdef unsigned char[:] view = <unsigned char[:totalsize]>base
+        block = np.asarray(view, copy=False).view(dt)
+        return block.reshape(len(idxs), rowsize // dt.itemsize)[:, :count]
+
+
     def execute(State self):
         """
         Executes the c library on the current state. Returns None on success,
         otherwise a string detailing the error that occurred (the first line of
-        this error string will always be the source location).
+        this error string will always be the source location). The GIL is
+        released for the duration, so separate states may be executed from
+        separate python threads concurrently. The state cannot be modified while
+        executing.
         """
+        self._check_idle()
         # Since we already have our state array in a format c can work with, we
-        # can jus hand it over.
-        cdef const char* ret = c_execute(self._array, self._interp._hash)
+        # can jus hand it over. Its arrays stay alive since they can't be
+        # changed until this returns.
+        cdef c_eight_bytes* array = self._array
+        cdef c_IH ih = self._interp._hash
+        cdef const char* ret
+        self._executing = 1
+        try:
+            with nogil:
+                ret = c_execute(array, ih)
+        finally:
+            self._executing = 0
         # Return success or convert ret to string.
         if ret == NULL:
             return None
         return ret.decode("utf-8")
 
 
+    def execute_async(State self):
+        """
+        Begins executing the c library on the current state in a background
+        thread, returning an `Execution` to watch, wait on or cancel it. The
+        state cannot be modified until the execution has finished.
+        """
+        self._check_idle()
+        cdef Execution execution = Execution.__new__(Execution)
+        execution._state = self
+        execution._result = None
+        execution._finished = 0
+        c_progress_reset(&execution._progress)
+        execution._thread = threading.Thread(target=execution._run,
+                                             name="bruv-execute")
+        self._executing = 1
+        try:
+            execution._thread.start()
+        except:
+            self._executing = 0
+            raise
+        return execution
+
+
     def __repr__(State self):
         cdef c_eight_bytes raw
         cdef double asfloat
@@ -294,6 +430,21 @@ cdef class State:
 
     cdef Interpretation _interp
     cdef c_eight_bytes* _array
+    cdef int _executing
+    cdef list _arenas # allocations of each `arena` block.
+    cdef set _in_arena # slots pointing into an arena block.
+
+    cdef _check_idle(State self):
+        if self._executing:
+            raise RuntimeError("cannot modify an executing state")
+
+    cdef _detach(State self, int idx):
+        # Frees the slot's array (unless its within an arena) and nulls it.
+        if idx in self._in_arena:
+            self._in_arena.discard(idx)
+        else:
+            free(<void*>self._array[idx])
+        self._array[idx] = <c_eight_bytes>0
 
     def _get(State self, int idx):
         if not (0 <= idx and idx < self._interp._length):
@@ -309,7 +460,280 @@ cdef class State:
         for (i, itype, _) in self._interp._mapping.values():
             if itype == Interpretation.F64 or itype == Interpretation.I64:
                 continue
+            if i in self._in_arena:
+                continue
             free(<void*>self._array[i])
+        for raw in self._arenas:
+            free(<void*><uintptr_t>raw)
+        self._arenas = []
         # textbook pointer deallocation. right proper stuff.
         free(self._array)
         self._array = NULL
+
+
+
+
+cdef class Execution:
+    """
+    Handle to an execution running in the background, as made by
+    `State.execute_async`.
+    """
+
+    def poll(Execution self):
+        """
+        Returns true if the execution has finished (successfully or not).
+        """
+        return self._finished != 0
+
+    def result(Execution self, object timeout=None):
+        """
+        Waits up to `timeout` seconds (or forever if None) for the execution to
+        finish, raising `TimeoutError` if it hasn't. Returns None on success,
+        otherwise a string detailing the error that occurred (as per
+        `State.execute`, which is "execution cancelled" if it was cancelled).
+        """
+        self._thread.join(timeout)
+        if not self._finished:
+            raise TimeoutError("execution still running")
+        return self._result
+
+    def progress(Execution self):
+        """
+        Returns a snapshot of the optimiser's progress, as a dict of:
+        - "iterations": optimiser iterations begun.
+        - "evaluations": cost evaluations completed.
+        - "best_cost": lowest cost evaluated, nan before any.
+        - "cancelled": whether cancellation has been requested.
+        Never blocks the execution, so may be called as often as liked.
+        """
+        cdef c_Progress snap
+        c_progress_read(&self._progress, &snap)
+        return {
+            "iterations": int(snap.iterations),
+            "evaluations": int(snap.evaluations),
+            "best_cost": float(snap.best_cost),
+            "cancelled": snap.cancel != 0,
+        }
+
+    def cancel(Execution self):
+        """
+        Requests the execution stop, which happens at its next cost evaluation
+        (so `result` gives an error). Has no effect once finished, or during the
+        final simulation after optimisation.
+        """
+        c_progress_cancel(&self._progress)
+
+
+    # PRIVATE
+
+    cdef State _state
+    cdef c_Progress _progress # written by the c while running.
+    cdef object _thread
+    cdef object _result
+    cdef int _finished
+
+    def _run(Execution self):
+        # Body of the background thread.
+        cdef c_eight_bytes* array = self._state._array
+        cdef c_IH ih = self._state._interp._hash
+        cdef c_Progress* progress = &self._progress
+        cdef const char* ret = NULL
+        try:
+            with nogil:
+                ret = c_execute_watched(array, ih, progress)
+            if ret != NULL:
+                self._result = ret.decode("utf-8")
+        finally:
+            self._state._executing = 0
+            self._finished = 1
+
+
+
+
+cdef class StateBatch:
+    def __cinit__(StateBatch self, Interpretation interp, object n):
+        """
+        Creates `n` zeroed state arrays, interpreted as per the given `interp`.
+        They are stored back to back, so each slot is a column across them.
+        """
+        self._array = NULL # in-case of throw
+        self._executing = 0
+        self._arenas = []
+        if not interp._finalised:
+            raise ValueError("requires finalised interpretation")
+        if type(n) is not int:
+            raise ValueError("expected integer count, got "
+                            f"{repr(type(n).__name__)}")
+        if n < 0:
+            raise ValueError(f"expected non-negative count, got {n}")
+        cdef long long size = max(1, n * interp._length * 8)
+        self._array = <c_eight_bytes*>malloc(size)
+        if self._array == NULL:
+            raise MemoryError("cooked")
+        memset(self._array, 0, size)
+        self._interp = interp
+        self._n = n
+
+
+    def __len__(StateBatch self):
+        return self._n
+
+
+    def __getitem__(StateBatch self, str name):
+        """
+        Returns the scalar slot `name` of every state, as a zero-copy (strided)
+        numpy view. Only valid for the lifetime of this batch.
+        """
+        if name not in self._interp._mapping:
+            raise KeyError(f"missing name: {repr(name)}")
+        idx, itype, _ = self._interp._mapping[name]
+        if itype == Interpretation.F64:
+            dt = np.dtype("=f8")
+        elif itype == Interpretation.I64:
+            dt = np.dtype("=i8")
+        else:
+            raise TypeError(f"array slots are only given via `arena`: "
+                            f"{repr(name)}")
+        return self._block()[:, idx].view(dt)
+
+
+    def __setitem__(StateBatch self, str name, object value):
+        """
+        Sets the scalar slot `name` of every state, to either a single value or
+        one per state.
+        """
+        self._check_idle()
+        self[name][:] = value
+
+
+    def arena(StateBatch self, list names, object count):
+        """
+        As `State.arena`, but giving every state its own rows. Returns the block
+        as a zero-copy 3D numpy view, indexed by state, then name (in the given
+        order), then element.
+        """
+        if type(count) is not int:
+            raise ValueError("expected integer count, got "
+                            f"{repr(type(count).__name__)}")
+        if count < 0:
+            raise ValueError(f"expected non-negative count, got {count}")
+        if not names:
+            raise ValueError("expected at least one name")
+        self._check_idle()
+        itype = None
+        idxs = []
+        for name in names:
+            if name not in self._interp._mapping:
+                raise KeyError(f"missing name: {repr(name)}")
+            idx, t, _ = self._interp._mapping[name]
+            if t == Interpretation.F64 or t == Interpretation.I64:
+                raise TypeError(f"not an array: {repr(name)}")
+            if itype is not None and t != itype:
+                raise TypeError(f"mismatched array type: {repr(name)}")
+            if idx in idxs:
+                raise ValueError(f"name repeated: {repr(name)}")
+            itype = t
+            idxs.append(idx)
+        dt = State._TO_DTYPE[itype]
+
+        # Same layout as `State.arena`, with each state's rows back to back.
+        cdef long long rowsize = ((count * dt.itemsize + 63) // 64) * 64
+        cdef long long rows = self._n * len(idxs)
+        cdef long long totalsize = rowsize * rows
+        cdef void* raw = malloc(totalsize + 64)
+        if raw == NULL:
+            raise MemoryError()
+        self._arenas.append(<uintptr_t>raw)
+        cdef unsigned char* base = <unsigned char*>(
+                (<uintptr_t>raw + 63) & ~(<uintptr_t>63))
+        memset(base, 0, totalsize)
+
+        # Any previous block is left be, since its views may still be held.
+        cdef long long length = self._interp._length
+        cdef Py_ssize_t i
+        cdef Py_ssize_t j
+        cdef Py_ssize_t k
+        cdef void* ptr
+        for i in range(self._n):
+            for j, k in enumerate(idxs):
+                ptr = <void*>(base + (i*len(idxs) + j)*rowsize)
+                memcpy(&self._array[i*length + k], &ptr, 8)
+
+        if totalsize == 0:
+            return np.empty((self._n, len(idxs), count), dtype=dt)
+        cdef unsigned char[:] view = <unsigned char[:totalsize]>base
+        block = np.asarray(view, copy=False).view(dt)
+        block = block.reshape(self._n, len(idxs), rowsize // dt.itemsize)
+        return block[:, :, :count]
+
+
+    def execute(StateBatch self, object threads=1):
+        """
+        Executes every state in one call to the c, spread over `threads` threads
+        and with the GIL released. Returns a list with an entry per state, None
+        if it succeeded otherwise a string detailing the error that occurred (as
+        per `State.execute`). Raises if the batch as a whole couldn't be run.
+        Note the profile and count outputs are shared by the states which were
+        run together.
+        """
+        if type(threads) is not int:
+            raise ValueError("expected integer thread count, got "
+                            f"{repr(type(threads).__name__)}")
+        self._check_idle()
+        cdef char* errors = <char*>malloc(max(1, self._n * C_ERROR_SIZE))
+        if errors == NULL:
+            raise MemoryError()
+        cdef c_eight_bytes* array = self._array
+        cdef long long n = self._n
+        cdef c_IH ih = self._interp._hash
+        cdef long long c_threads = threads
+        cdef const char* ret
+        cdef Py_ssize_t i
+        self._executing = 1
+        try:
+            with nogil:
+                ret = c_execute_batch(array, n, ih, c_threads, errors)
+            if ret != NULL:
+                raise RuntimeError(ret.decode("utf-8"))
+            results = []
+            for i in range(self._n):
+                if errors[i * C_ERROR_SIZE] == 0:
+                    results.append(None)
+                else:
+                    results.append((errors + i * C_ERROR_SIZE).decode("utf-8"))
+            return results
+        finally:
+            self._executing = 0
+            free(errors)
+
+
+    # PRIVATE
+
+    cdef Interpretation _interp
+    cdef c_eight_bytes* _array
+    cdef long long _n
+    cdef int _executing
+    cdef list _arenas # allocations of each `arena` block.
+
+    cdef _check_idle(StateBatch self):
+        if self._executing:
+            raise RuntimeError("cannot modify an executing batch")
+
+    def _block(StateBatch self):
+        # Every state array, as rows of raw slots.
+        cdef long long length = self._interp._length
+        cdef long long totalsize = self._n * length * 8
+        if totalsize == 0:
+            return np.empty((self._n, length), dtype=np.uint64)
+        cdef unsigned char[:] view = (
+                <unsigned char[:totalsize]><unsigned char*>self._array)
+        block = np.asarray(view, copy=False).view(np.uint64)
+        return block.reshape(self._n, length)
+
+    def __dealloc__(self):
+        # only arena blocks are ever pointed to.
+        for raw in self._arenas:
+            free(<void*><uintptr_t>raw)
+        self._arenas = []
+        free(self._array)
+        self._array = NULL
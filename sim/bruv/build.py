@@ -2,9 +2,13 @@
 Compiles the c library and cythonises the bridge module.
 """
 
+import array
 import json
+import math
 import os
+import re
 import shutil
+import struct
 import subprocess
 import sys
 import traceback
@@ -108,6 +112,14 @@ def _needa_c(deps, built):
     return False
 
 
+def _needa_tables(deps, built): # same deal as _needa_c
+    if not all(p.is_file() for p in built):
+        return True
+    if paths.max_mtime(deps) > paths.max_mtime(built):
+        return True
+    return False
+
+
 def _needa_bridge(deps, built): # same deal as _needa_c
     if not all(p.is_file() for p in built):
         return True
@@ -223,6 +235,8 @@ def _gcc_cmd(extra_args=(), out_paths=None, dynamic_lib=True):
 
         "-fno-ident", # gootbye gcc signature.
 
+        "-pthread", # thermal march may be multithreaded.
+
         "-fno-exceptions",
         "-fno-unwind-tables",
         "-fno-asynchronous-unwind-tables",
@@ -365,6 +379,98 @@ def _build_c(deps, gcc_extra_args=()):
     return builds_lib
 
 
+# Must match c/lut.h.
+_LUT_MAGIC = 0x0054554C56555242
+_LUT_VERSION = 2
+_LUT_FILE_HEADER = struct.Struct("=Qqqq")
+_LUT_TABLE = struct.Struct("=32s8d4q")
+_LUT_ALIGN = 64
+
+def _parse_table(path):
+    # Table sources are as written by the approximator, a header of comments
+    # followed by the (C-syntax) f32 array. 3D tables also have a z range.
+    text = path.read_text(encoding="utf-8")
+    def header(key, pattern, optional=False):
+        m = re.search(rf"/\* {key}: {pattern} \*/", text)
+        if m is None:
+            if optional:
+                return None
+            print(f"error: table {paths.shortstr(path)} has missing or "
+                  f"invalid '{key}'\n")
+            raise BuildError()
+        return m.groups()
+    xlo, xhi = map(float, header("x", r"\[(\S+), (\S+)\]"))
+    ylo, yhi = map(float, header("y", r"\[(\S+), (\S+)\]"))
+    zbounds = header("z", r"\[(\S+), (\S+)\]", optional=True)
+    zlo, zhi = (0.0, 0.0) if zbounds is None else map(float, zbounds)
+    xlen, ylen, zlen = header("shape", r"(\d+)x(\d+)(?:x(\d+))?")
+    xlen, ylen = int(xlen), int(ylen)
+    if (zlen is None) != (zbounds is None):
+        print(f"error: table {paths.shortstr(path)} has mismatched z range "
+              f"and shape\n")
+        raise BuildError()
+    zlen = 1 if zlen is None else int(zlen)
+    abserr, relerr = (float(x)/100 for x in header("max error of",
+            r"abs (\S+)%, rel (\S+)%"))
+
+    body = text[text.index("{") + 1:text.rindex("}")]
+    entries = [e.strip() for e in body.split(",") if e.strip()]
+    def parse(e):
+        return math.nan if e == "fNAN" else float(e.removesuffix("f"))
+    data = array.array("f", map(parse, entries))
+    if len(data) != xlen*ylen*zlen:
+        print(f"error: table {paths.shortstr(path)} has {len(data)} entries, "
+              f"expected {xlen}x{ylen}x{zlen}\n")
+        raise BuildError()
+    if not (xlo < xhi and ylo < yhi and xlen >= 2 and ylen >= 2):
+        print(f"error: table {paths.shortstr(path)} has invalid bounds/shape\n")
+        raise BuildError()
+    if zbounds is not None and not (zlo < zhi and zlen >= 2):
+        print(f"error: table {paths.shortstr(path)} has invalid bounds/shape\n")
+        raise BuildError()
+    return (xlo, xhi, ylo, yhi, zlo, zhi, abserr, relerr, xlen, ylen, zlen), data
+
+def _build_tables(deps):
+    srcs = sorted(p for p in deps if p.suffix == ".i")
+    if not srcs:
+        print("error: must have at least one table (.i) file\n")
+        raise BuildError()
+    parsed = [(p.stem, *_parse_table(p)) for p in srcs]
+
+    align = lambda x: -(-x // _LUT_ALIGN) * _LUT_ALIGN
+    offset = align(_LUT_FILE_HEADER.size + len(parsed)*_LUT_TABLE.size)
+    headers = []
+    for name, meta, data in parsed:
+        bytesname = name.encode("utf-8")
+        if len(bytesname) >= 32:
+            print(f"error: table name too long: {repr(name)}\n")
+            raise BuildError()
+        headers.append(_LUT_TABLE.pack(bytesname, *meta, offset))
+        offset = align(offset + len(data)*data.itemsize)
+    size = offset
+
+    blob = bytearray(size)
+    _LUT_FILE_HEADER.pack_into(blob, 0, _LUT_MAGIC, _LUT_VERSION, len(parsed),
+            size)
+    pos = _LUT_FILE_HEADER.size
+    for header in headers:
+        blob[pos:pos + len(header)] = header
+        pos += len(header)
+    for header, (_, _, data) in zip(headers, parsed):
+        offset = _LUT_TABLE.unpack(header)[-1]
+        raw = data.tobytes()
+        blob[offset:offset + len(raw)] = raw
+
+    # Write to a temporary then swap it in, since other processes may currently
+    # have the old file mapped.
+    paths.BIN_C.mkdir(parents=True, exist_ok=True)
+    tmp = paths.C_TABLES.with_suffix(".tmp")
+    tmp.write_bytes(blob)
+    os.replace(tmp, paths.C_TABLES)
+    print(f"packed {len(parsed)} tables into {paths.shortstr(paths.C_TABLES)} "
+          f"({size/1024:.0f} KiB)")
+
+
 def _build_bridge(deps):
 
     # Ensure output dir.
@@ -456,6 +562,8 @@ def build(gcc_extra_args=(), must=True):
     # Recompute dependancies and previous build products.
     c_deps = paths.c_deps()
     c_built = paths.c_built()
+    tables_deps = paths.tables_deps()
+    tables_built = paths.tables_built()
     bridge_deps = paths.bridge_deps()
     bridge_built = paths.bridge_built()
 
@@ -483,6 +591,20 @@ def build(gcc_extra_args=(), must=True):
             pass
         raise
 
+    try:
+        if not must and not _needa_tables(tables_deps, tables_built):
+            print("Using previously packed property tables.\n")
+        else:
+            print("Packing property tables...\n")
+            _build_tables(tables_deps)
+            print("Packed property tables.\n")
+    except BuildError:
+        try:
+            paths.C_TABLES.unlink(missing_ok=True)
+        except Exception:
+            pass
+        raise
+
     try:
         if not must and not _needa_bridge(bridge_deps, bridge_built):
             print("Using previously cythonised bridge.\n")
@@ -0,0 +1,78 @@
+"""
+Compiles and runs the check of the parallel coolant march against the serial
+one.
+"""
+
+import json
+import os
+import subprocess
+import sys
+import traceback
+from pathlib import Path
+
+from . import build
+from . import paths
+
+__all__ = ["build_march"]
+
+
+
+def build_march(gcc_extra_args=()):
+    # Very similar to ./build.py::_build_sim
+
+    os.system("")
+
+    out_paths = {
+        "final": paths.MARCH_EXE,
+        "prepro": paths.MARCH_PREPRO,
+        "disas": paths.MARCH_DISAS,
+        "obj": paths.MARCH_OBJ,
+    }
+    cmd, builds_final, out = build._gcc_cmd(
+        ("-DMARCH=1", *gcc_extra_args),
+        out_paths=out_paths,
+        dynamic_lib=False
+    )
+    print(f">> {' '.join(cmd)}\n")
+
+    out.parent.mkdir(parents=True, exist_ok=True)
+
+    srcs = [p for p in paths.subfiles(paths.C) if p.suffix == ".c"]
+    srcs = sorted(srcs)
+    if not srcs:
+        print("error: must have at least one source c (.c) file\n")
+        raise build.BuildError()
+    def to_include(p):
+        path = p.relative_to(paths.C).as_posix()
+        path = json.dumps(path)
+        return f"#include {path}\n"
+    godfile = "".join(to_include(p) for p in srcs)
+
+    proc = subprocess.Popen(
+        cmd,
+        bufsize=-1, cwd=paths.C, text=True,
+        stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+        stdin=subprocess.PIPE
+    )
+    output, _ = proc.communicate(godfile)
+
+    if proc.returncode or output:
+        print("error: when running gcc:")
+        print(output)
+        print()
+        raise build.BuildError()
+
+    print(f"Built march at: {paths.shortstr(out)}\n")
+
+    proc = subprocess.run([str(out), str(paths.C_TABLES)], cwd=paths.OUT)
+    if proc.returncode:
+        print("error: march check failed\n")
+        raise build.BuildError()
+
+
+if __name__ == "__main__":
+    try:
+        build_march(sys.argv[1:])
+        sys.exit(0)
+    except build.BuildError:
+        sys.exit(1)
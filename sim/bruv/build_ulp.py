@@ -0,0 +1,77 @@
+"""
+Compiles and runs the ulp check of the vector maths against scalar.
+"""
+
+import json
+import os
+import subprocess
+import sys
+import traceback
+from pathlib import Path
+
+from . import build
+from . import paths
+
+__all__ = ["build_ulp"]
+
+
+
+def build_ulp(gcc_extra_args=()):
+    # Very similar to ./build.py::_build_sim
+
+    os.system("")
+
+    out_paths = {
+        "final": paths.ULP_EXE,
+        "prepro": paths.ULP_PREPRO,
+        "disas": paths.ULP_DISAS,
+        "obj": paths.ULP_OBJ,
+    }
+    cmd, builds_final, out = build._gcc_cmd(
+        ("-DULP=1", *gcc_extra_args),
+        out_paths=out_paths,
+        dynamic_lib=False
+    )
+    print(f">> {' '.join(cmd)}\n")
+
+    out.parent.mkdir(parents=True, exist_ok=True)
+
+    srcs = [p for p in paths.subfiles(paths.C) if p.suffix == ".c"]
+    srcs = sorted(srcs)
+    if not srcs:
+        print("error: must have at least one source c (.c) file\n")
+        raise build.BuildError()
+    def to_include(p):
+        path = p.relative_to(paths.C).as_posix()
+        path = json.dumps(path)
+        return f"#include {path}\n"
+    godfile = "".join(to_include(p) for p in srcs)
+
+    proc = subprocess.Popen(
+        cmd,
+        bufsize=-1, cwd=paths.C, text=True,
+        stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+        stdin=subprocess.PIPE
+    )
+    output, _ = proc.communicate(godfile)
+
+    if proc.returncode or output:
+        print("error: when running gcc:")
+        print(output)
+        print()
+        raise build.BuildError()
+
+    print(f"Built ulp at: {paths.shortstr(out)}\n")
+
+    proc = subprocess.run([str(out)], cwd=paths.OUT)
+    if proc.returncode:
+        print("error: ulp check failed\n")
+        raise build.BuildError()
+
+
+if __name__ == "__main__":
+    try:
+        build_ulp(sys.argv[1:])
+        sys.exit(0)
+    except build.BuildError:
+        sys.exit(1)
@@ -5,6 +5,14 @@ const char* assertion_message(void) {
     return (const char*)assert_msg_;
 }
 
+void assertion_rethrow(const char* msg) {
+    if (msg != assert_msg_) {
+        __builtin_strncpy(assert_msg_, msg, numel(assert_msg_) - 1);
+        assert_msg_[numel(assert_msg_) - 1] = '\0';
+    }
+    longjmp(assert_jump_, 1);
+}
+
 
-typeof(assert_jump_) assert_jump_;
-typeof(assert_msg_) assert_msg_;
+_Thread_local typeof(assert_jump_) assert_jump_;
+_Thread_local typeof(assert_msg_) assert_msg_;
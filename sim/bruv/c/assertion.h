@@ -12,6 +12,19 @@
 // Returns the message of an assert. Only valid if an assert has failed.
 const char* assertion_message(void);
 
+// Fails an assertion with the given message, as though it had been raised here.
+// Used to pass on the failure of another thread.
+NORETURN void assertion_rethrow(const char* msg);
+
+// Saves the handler of the most recent `assertion_has_failed` into the `jmp_buf`
+// `saved`, to be reinstated by `assertion_restore` once done with a nested
+// handler. This lets a caller clean up after a failure and then pass it on (via
+// `assertion_rethrow`) to the handler it was itself called under.
+#define assertion_save(saved)                                                   \
+    __builtin_memcpy((saved), assert_jump_, sizeof(jmp_buf))
+#define assertion_restore(saved)                                                \
+    __builtin_memcpy(assert_jump_, (saved), sizeof(jmp_buf))
+
 // Asserts that `x` is non-zero. If `x` is zero, the assertion fails and the most
 // recent call of `assertion_has_failed` is jumped to, with `fmt_and_args` parsed
 // in a printf-manner and used as the error message.
@@ -38,5 +51,6 @@ const char* assertion_message(void);
 
 /* PRIVATE */
 
-extern jmp_buf assert_jump_;
-extern char assert_msg_[1024];
+// Per-thread, so each thread jumps back to its own `assertion_has_failed`.
+extern _Thread_local jmp_buf assert_jump_;
+extern _Thread_local char assert_msg_[1024];
@@ -44,6 +44,26 @@ vec4 vec4_from_vec3(vec3 xyz, f32 w) {
     return xyz;
 }
 
+dvec2 dvec2_copy(dvec2 xy) { return xy; }
+dvec4 dvec4_copy(dvec4 xyzw) { return xyzw; }
+
+dvec2 dvec2_from_elems(f64 x, f64 y) {
+    return (dvec2){ x, y };
+}
+dvec4 dvec4_from_elems(f64 x, f64 y, f64 z, f64 w) {
+    return (dvec4){ x, y, z, w };
+}
+
+dvec2 dvec2_from_rep(f64 x) { return (dvec2){ x, x }; }
+dvec4 dvec4_from_rep(f64 x) { return (dvec4){ x, x, x, x }; }
+
+dvec2 dvec2_from_array(const f64* xy) {
+    return (dvec2){ xy[0], xy[1] };
+}
+dvec4 dvec4_from_array(const f64* xyzw) {
+    return (dvec4){ xyzw[0], xyzw[1], xyzw[2], xyzw[3] };
+}
+
 
 
 // LIMITS //
@@ -73,6 +93,16 @@ i32x4 fp_bits_vec4(vec4 f) {
     memcpy(&i, &f, sizeof(i));
     return i;
 }
+i64x2 fp_bits_dvec2(dvec2 f) {
+    i64x2 i;
+    memcpy(&i, &f, sizeof(i));
+    return i;
+}
+i64x4 fp_bits_dvec4(dvec4 f) {
+    i64x4 i;
+    memcpy(&i, &f, sizeof(i));
+    return i;
+}
 
 f32 fp_from_bits_f32(u32 i) {
     f32 f;
@@ -99,3 +129,13 @@ vec4 fp_from_bits_vec4(i32x4 i) {
     memcpy(&f, &i, sizeof(f));
     return f;
 }
+dvec2 fp_from_bits_dvec2(i64x2 i) {
+    dvec2 f;
+    memcpy(&f, &i, sizeof(f));
+    return f;
+}
+dvec4 fp_from_bits_dvec4(i64x4 i) {
+    dvec4 f;
+    memcpy(&f, &i, sizeof(f));
+    return f;
+}
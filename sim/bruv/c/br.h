@@ -81,11 +81,26 @@ typedef f32 vec4 __attribute((__vector_size__(16)));
 typedef vec4 vec3 __attribute((VEC3_ATTR));
 
 
+// The simulation is all f64, so we also have double-precision vectors. These
+// are only for batching lanes of identical work (not geometry), hence there's
+// no three element version.
+
+// 16B aligned ordered collection of two `f64`s (one SSE2 register).
+typedef f64 dvec2 __attribute((__vector_size__(16)));
+// Ordered collection of four `f64`s (one AVX register, or two SSE2 registers).
+// Note this is only 16B aligned, since mingw doesn't realign the stack to 32B
+// and so would fault on aligned AVX spills. Unaligned loads of aligned data are
+// free anyway.
+typedef f64 dvec4 __attribute((__vector_size__(32), __aligned__(16)));
+
+
 // Not considered "vectors" (since they aren't floating point) but still useful
 // (especially for storing element-wise comparisons of vectors):
 
 typedef i32 i32x2 __attribute((__vector_size__(8)));
 typedef i32 i32x4 __attribute((__vector_size__(16)));
+typedef i64 i64x2 __attribute((__vector_size__(16)));
+typedef i64 i64x4 __attribute((__vector_size__(32), __aligned__(16)));
 
 
 // Unaligned and aliasing integers:
@@ -204,6 +219,35 @@ vec3 vec3_from_vec4(vec4 x);
 vec4 vec4_from_vec3(vec3 xyz, f32 w);
 
 
+// Constructs a `dvec2` from the given arguments.
+// - Overloaded:
+//      dvec2(dvec2 xy) -> (xy[0], xy[1])
+//      dvec2(f64 x, f64 y) -> (x, y)
+//      dvec2(f64[2] xy) -> (xy[0], xy[1])
+//      dvec2(f64 x) -> (x, x)
+#define dvec2(xs...) ( GLUE2(dvec2_, countva(xs)) (xs) )
+
+// Constructs a `dvec4` from the given arguments.
+// - Overloaded:
+//      dvec4(dvec4 xyzw) -> (xyzw[0], xyzw[1], xyzw[2], xyzw[3])
+//      dvec4(f64 x, f64 y, f64 z, f64 w) -> (x, y, z, w)
+//      dvec4(f64[4] xyzw) -> (xyzw[0], xyzw[1], xyzw[2], xyzw[3])
+//      dvec4(f64 x) -> (x, x, x, x)
+#define dvec4(xs...) ( GLUE2(dvec4_, countva(xs)) (xs) )
+
+dvec2 dvec2_copy(dvec2 xy);
+dvec4 dvec4_copy(dvec4 xyzw);
+
+dvec2 dvec2_from_elems(f64 x, f64 y);
+dvec4 dvec4_from_elems(f64 x, f64 y, f64 z, f64 w);
+
+dvec2 dvec2_from_rep(f64 x);
+dvec4 dvec4_from_rep(f64 x);
+
+dvec2 dvec2_from_array(const f64* xy);
+dvec4 dvec4_from_array(const f64* xyzw);
+
+
 // Note the cheeky vector constructors shadow the type name themselves, but will
 // only overwrite when invoked with brackets.... so like maybe on function
 // pointer prototypes? in that case use these helpful aliases:
@@ -211,6 +255,8 @@ vec4 vec4_from_vec3(vec3 xyz, f32 w);
 typedef vec2 also_vec2;
 typedef vec3 also_vec3;
 typedef vec4 also_vec4;
+typedef dvec2 also_dvec2;
+typedef dvec4 also_dvec4;
 
 
 
@@ -326,20 +372,28 @@ typedef vec4 also_vec4;
 #define v2NAN ( (vec2){ REPEAT(2, __builtin_nanf(""), ) } )
 #define v3NAN ( (vec3){ REPEAT(4, __builtin_nanf(""), ) } )
 #define v4NAN ( (vec4){ REPEAT(4, __builtin_nanf(""), ) } )
+#define dv2NAN ( (dvec2){ REPEAT(2, __builtin_nan(""), ) } )
+#define dv4NAN ( (dvec4){ REPEAT(4, __builtin_nan(""), ) } )
 
 #define INF   ( __builtin_inf() )
 #define fINF  ( __builtin_inff() )
 #define v2INF ( (vec2){ REPEAT(2, __builtin_inff(), ) } )
 #define v3INF ( (vec3){ REPEAT(4, __builtin_inff(), ) } )
 #define v4INF ( (vec4){ REPEAT(4, __builtin_inff(), ) } )
+#define dv2INF ( (dvec2){ REPEAT(2, __builtin_inf(), ) } )
+#define dv4INF ( (dvec4){ REPEAT(4, __builtin_inf(), ) } )
 
 #define v2ZERO ( (vec2){ REPEAT(2, 0.f, ) } )
 #define v3ZERO ( (vec3){ REPEAT(4, 0.f, ) } )
 #define v4ZERO ( (vec4){ REPEAT(4, 0.f, ) } )
+#define dv2ZERO ( (dvec2){ REPEAT(2, 0.0, ) } )
+#define dv4ZERO ( (dvec4){ REPEAT(4, 0.0, ) } )
 
 #define v2ONE ( (vec2){ REPEAT(2, 1.f, ) } )
 #define v3ONE ( (vec3){ REPEAT(4, 1.f, ) } )
 #define v4ONE ( (vec4){ REPEAT(4, 1.f, ) } )
+#define dv2ONE ( (dvec2){ REPEAT(2, 1.0, ) } )
+#define dv4ONE ( (dvec4){ REPEAT(4, 1.0, ) } )
 
 #define v2X ( (vec2){ 1.f, 0.f } )
 #define v2Y ( (vec2){ 0.f, 1.f } )
@@ -362,6 +416,8 @@ typedef vec4 also_vec4;
         ,           vec2: v2ZERO                    \
         , genuinely_vec3: v3ZERO                    \
         ,           vec4: v4ZERO                    \
+        ,          dvec2: dv2ZERO                   \
+        ,          dvec4: dv4ZERO                   \
     ) )
 
 
@@ -373,6 +429,8 @@ typedef vec4 also_vec4;
         ,           vec2: v2ONE                 \
         , genuinely_vec3: v3ONE                 \
         ,           vec4: v4ONE                 \
+        ,          dvec2: dv2ONE                \
+        ,          dvec4: dv4ONE                \
     ) )
 
 
@@ -386,6 +444,8 @@ typedef vec4 also_vec4;
         ,           vec2: v2NAN                 \
         , genuinely_vec3: v3NAN                 \
         ,           vec4: v4NAN                 \
+        ,          dvec2: dv2NAN                \
+        ,          dvec4: dv4NAN                \
     ) )
 
 
@@ -397,6 +457,8 @@ typedef vec4 also_vec4;
         ,           vec2: v2INF                 \
         , genuinely_vec3: v3INF                 \
         ,           vec4: v4INF                 \
+        ,          dvec2: dv2INF                \
+        ,          dvec4: dv4INF                \
     ) )
 
 
@@ -408,37 +470,50 @@ typedef vec4 also_vec4;
 //      f32 -> u32
 //      vec2 -> i32x2
 //      vec3/4 -> i32x4
+//      dvec2 -> i64x2
+//      dvec4 -> i64x4
 #define fp_bits(f...) ( generic((f) \
-        ,  f64: fp_bits_f64         \
-        ,  f32: fp_bits_f32         \
-        , vec2: fp_bits_vec2        \
-        , vec4: fp_bits_vec4        \
+        ,   f64: fp_bits_f64        \
+        ,   f32: fp_bits_f32        \
+        ,  vec2: fp_bits_vec2       \
+        ,  vec4: fp_bits_vec4       \
+        , dvec2: fp_bits_dvec2      \
+        , dvec4: fp_bits_dvec4      \
     ) (f) )
 u32 fp_bits_f32(f32 f);
 u64 fp_bits_f64(f64 f);
 i32x2 fp_bits_vec2(vec2 f);
 i32x4 fp_bits_vec3(vec3 f);
 i32x4 fp_bits_vec4(vec4 f);
+i64x2 fp_bits_dvec2(dvec2 f);
+i64x4 fp_bits_dvec4(dvec4 f);
 
 // Returns the floating point that has the same size and bits as `i`.
-// - `i` must be an `i64`, `i32`, `i32x2`, or `i32x4` expression.
+// - `i` must be an `u64`, `u32`, `i32x2`, `i32x4`, `i64x2`, or `i64x4`
+//      expression.
 // - The memory of `i` is reinterpreted, no conversion takes place.
 // - Returns one of the following types:
 //      u64 -> f64
 //      u32 -> f32
 //      i32x2 -> vec2
 //      i32x4 -> vec4 (may be considered vec3)
+//      i64x2 -> dvec2
+//      i64x4 -> dvec4
 #define fp_from_bits(i...) ( generic((i)    \
         ,   u64: fp_from_bits_f64           \
         ,   u32: fp_from_bits_f32           \
         , i32x2: fp_from_bits_vec2          \
         , i32x4: fp_from_bits_vec4          \
+        , i64x2: fp_from_bits_dvec2         \
+        , i64x4: fp_from_bits_dvec4         \
     ) (i) )
 f32 fp_from_bits_f32(u32 i);
 f64 fp_from_bits_f64(u64 i);
 vec2 fp_from_bits_vec2(i32x2 i);
 vec4 fp_from_bits_vec3(i32x4 i);
 vec4 fp_from_bits_vec4(i32x4 i);
+dvec2 fp_from_bits_dvec2(i64x2 i);
+dvec4 fp_from_bits_dvec4(i64x4 i);
 
 
 // Expands to the greatest magnitude representable by a normal floating point
@@ -733,6 +808,9 @@ inline vec2 id_vec2(vec2 x) { return x; }
 inline vec3 id_vec3(vec3 x) { return x; }
 inline vec4 id_vec4(vec4 x) { return x; }
 
+inline dvec2 id_dvec2(dvec2 x) { return x; }
+inline dvec4 id_dvec4(dvec4 x) { return x; }
+
 
 
 // ========================== //
@@ -953,6 +1031,16 @@ inline vec4 id_vec4(vec4 x) { return x; }
 // - Function, variable, or type attribute.
 #define UNUSED __attribute((__unused__))
 
+// Forces this function to be inlined into every call site, even when optimising
+// wouldn't. Useful for specialising a function on constant arguments.
+// - Function attribute.
+#define ALWAYSINLINE __attribute((__always_inline__)) inline
+
+// Prevents this function from being inlined. Useful to keep the locals of a big
+// callee out of a function which calls `setjmp`.
+// - Function attribute.
+#define NEVERINLINE __attribute((__noinline__))
+
 // Forces this function to be emitted into the final program.
 // - Global/static function attribute.
 // - May be useful to view the assembly of a funcion.
@@ -129,6 +129,31 @@ static_assert(-1 == ~0);
     ) ((x))
 
 
+#define dvec2_2(x, y) dvec2_from_elems((x), (y))
+#define dvec4_4(x, y, z, w) dvec4_from_elems((x), (y), (z), (w))
+
+#define dvec2_1(x) generic(objof(typeof(x)*)    \
+        ,       f64(*)[2]: dvec2_from_array     \
+        , const f64(*)[2]: dvec2_from_array     \
+        , default: generic((x)                  \
+            ,     f64: dvec2_from_rep           \
+            ,     f32: dvec2_from_rep           \
+            ,   dvec2: dvec2_copy               \
+            , default: id_void                  \
+        )                                       \
+    ) ((x))
+#define dvec4_1(x) generic(objof(typeof(x)*)    \
+        ,       f64(*)[4]: dvec4_from_array     \
+        , const f64(*)[4]: dvec4_from_array     \
+        , default: generic((x)                  \
+            ,     f64: dvec4_from_rep           \
+            ,     f32: dvec4_from_rep           \
+            ,   dvec4: dvec4_copy               \
+            , default: id_void                  \
+        )                                       \
+    ) ((x))
+
+
 #if BR_COMPILING
 #define vec4_2(xyz, w) generic(distinguish_vec3(xyz)    \
         , genuinely_vec3: vec4_from_vec3                \
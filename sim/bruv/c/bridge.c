@@ -2,8 +2,13 @@
    c to be rebuilt rather than bridge.pyx. */
 
 #include "../bridge/bridge.h"
+
+#include <pthread.h>
+
 #include "assertion.h"
 #include "hash.h"
+#include "lut.h"
+#include "maths.h"
 #include "sim.h"
 
 
@@ -33,6 +38,8 @@ c_IH c_ih_append(c_IH running, const char* name, c_IHentry entry) {
 
 static_assert(sizeof(c_eight_bytes) == 8);
 
+// Thread-safe (the assertion state being per thread), so long as the tables
+// have been loaded.
 const char* c_execute(c_eight_bytes* state, c_IH interpretation_hash) {
     // Setup assert catch to handle ALL erroneous returns from this function.
     if (assertion_has_failed())
@@ -47,3 +54,140 @@ const char* c_execute(c_eight_bytes* state, c_IH interpretation_hash) {
     sim_execute((simState*)state /* reinterpret */);
     return NULL; // no error.
 }
+
+void c_progress_reset(c_Progress* progress) {
+    f64 nan = NAN;
+    __atomic_store_n(&progress->iterations, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&progress->evaluations, 0, __ATOMIC_RELAXED);
+    __atomic_store(&progress->best_cost, &nan, __ATOMIC_RELAXED);
+    __atomic_store_n(&progress->cancel, 0, __ATOMIC_RELEASE);
+}
+
+void c_progress_read(const c_Progress* progress, c_Progress* out) {
+    // Acquire the evaluation count first, so the other fields are at least as
+    // new as it.
+    out->evaluations = __atomic_load_n(&progress->evaluations,
+            __ATOMIC_ACQUIRE);
+    out->iterations = __atomic_load_n(&progress->iterations, __ATOMIC_RELAXED);
+    __atomic_load(&progress->best_cost, &out->best_cost, __ATOMIC_RELAXED);
+    out->cancel = __atomic_load_n(&progress->cancel, __ATOMIC_RELAXED);
+}
+
+void c_progress_cancel(c_Progress* progress) {
+    __atomic_store_n(&progress->cancel, 1, __ATOMIC_RELEASE);
+}
+
+const char* c_execute_watched(c_eight_bytes* state, c_IH interpretation_hash,
+        c_Progress* progress) {
+    if (assertion_has_failed())
+        return assertion_message();
+
+    assert(interpretation_hash == sim_interpretation_hash(),
+            "interpretation hash does not match, proposal is dismissed");
+    assert(progress != NULL, "missing progress");
+
+    sim_execute_watched((simState*)state /* reinterpret */, progress);
+    return NULL; // no error.
+}
+
+typedef struct cBatch_ {
+    simState* states;
+    i64 count;
+    char* errors;
+    i64 next; // first state of the next unclaimed group, atomically.
+} cBatch_;
+
+static void c_batch_error_(cBatch_* b, i64 i, const char* msg) {
+    char* dst = b->errors + i*C_ERROR_SIZE;
+    __builtin_strncpy(dst, msg, C_ERROR_SIZE - 1);
+    dst[C_ERROR_SIZE - 1] = '\0';
+}
+
+// Returns non-zero on success, otherwise the assertion message is set.
+static NEVERINLINE i32 c_batch_run_(simState* const* s, i32 count) {
+    if (assertion_has_failed())
+        return 0;
+    if (count == 1)
+        sim_execute(s[0]);
+    else
+        sim_execute_lanes(s, count);
+    return 1;
+}
+
+// Executes states [lo, hi) together, falling back to one at a time if any of
+// them fail.
+static void c_batch_group_(cBatch_* b, i64 lo, i64 hi) {
+    i32 n = (i32)(hi - lo);
+    simState backup[SIM_LANES];
+    simState* ptrs[SIM_LANES] = {0};
+    for (i32 k=0; k<n; ++k) {
+        backup[k] = b->states[lo + k];
+        ptrs[k] = &b->states[lo + k];
+        b->errors[(lo + k)*C_ERROR_SIZE] = '\0';
+    }
+    if (c_batch_run_(ptrs, n))
+        return;
+    if (n == 1) {
+        c_batch_error_(b, lo, assertion_message());
+        return;
+    }
+    // Inputs may have been partially overwritten, so start over from them.
+    for (i32 k=0; k<n; ++k) {
+        b->states[lo + k] = backup[k];
+        if (!c_batch_run_(&ptrs[k], 1))
+            c_batch_error_(b, lo + k, assertion_message());
+    }
+}
+
+static void* c_batch_worker_(void* arg) {
+    cBatch_* b = arg;
+    for (;;) {
+        i64 lo = __atomic_fetch_add(&b->next, SIM_LANES, __ATOMIC_RELAXED);
+        if (lo >= b->count)
+            break;
+        c_batch_group_(b, lo, min(lo + SIM_LANES, b->count));
+    }
+    return NULL;
+}
+
+const char* c_execute_batch(c_eight_bytes* states, long long count,
+        c_IH interpretation_hash, long long threads, char* errors) {
+    enum { MAX_THREADS = 64 };
+
+    if (assertion_has_failed())
+        return assertion_message();
+
+    assert(interpretation_hash == sim_interpretation_hash(),
+            "interpretation hash does not match, proposal is dismissed");
+    assert(count >= 0, "invalid batch count: %lld", count);
+    assert(1 <= threads && threads <= MAX_THREADS,
+            "invalid batch thread count: %lld", threads);
+
+    cBatch_* b = &(cBatch_){
+        .states = (simState*)states /* reinterpret */,
+        .count = count,
+        .errors = errors,
+        .next = 0,
+    };
+    // The calling thread is one of the workers, and if a thread can't be made
+    // the others just take its share.
+    pthread_t spawned[MAX_THREADS];
+    i32 spawned_count = 0;
+    for (i64 k=1; k<threads; ++k) {
+        if (pthread_create(&spawned[spawned_count], NULL, c_batch_worker_, b)
+                == 0)
+            ++spawned_count;
+    }
+    c_batch_worker_(b);
+    for (i32 k=0; k<spawned_count; ++k)
+        pthread_join(spawned[k], NULL);
+    return NULL; // no error (at least, not of the batch).
+}
+
+const char* c_load_tables(const char* path) {
+    if (assertion_has_failed())
+        return assertion_message();
+
+    lut_load(path);
+    return NULL; // no error.
+}
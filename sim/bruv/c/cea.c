@@ -1,416 +1,247 @@
 #include "cea.h"
 
 #include "assertion.h"
+#include "lut.h"
 #include "maths.h"
+#include "profile.h"
 
 
-#define CEA_2DLOOKUP() do {                                                 \
+#define CEA_2DLOOKUP_(kernel, name) do {                                    \
+        const lutTable* lut = lut_get(LUT_##name);                          \
+        COUNT_ADD(cea_lookups, 1);                                          \
         f64 x = P0_cc*1e-6;                                                 \
         f64 y = ofr;                                                        \
-        assert(XLO <= x && x <= XHI, "approximation input oob: x=%g", x);   \
-        assert(YLO <= y && y <= YHI, "approximation input oob: y=%g", y);   \
-        f64 t = (x - XLO) / (XHI - XLO);                                    \
-        f64 s = (y - YLO) / (YHI - YLO);                                    \
-        t *= XLEN - 1;                                                      \
-        s *= YLEN - 1;                                                      \
-        i32 i = min(max((i32)t, 0), XLEN - 2);                              \
-        i32 j = min(max((i32)s, 0), YLEN - 2);                              \
-        t -= i;                                                             \
-        s -= j;                                                             \
-        f64 v00 = tbl[YLEN*i + j];                                          \
-        f64 v01 = tbl[YLEN*i + j + 1];                                      \
-        f64 v10 = tbl[YLEN*(i + 1) + j];                                    \
-        f64 v11 = tbl[YLEN*(i + 1) + j + 1];                                \
-        f64 v0 = v00 + s*(v01 - v00);                                       \
-        f64 v1 = v10 + s*(v11 - v10);                                       \
-        f64 v = v0 + t*(v1 - v0);                                           \
+        assert(lut->xlo <= x && x <= lut->xhi,                              \
+                "approximation input oob: x=%g", x);                        \
+        assert(lut->ylo <= y && y <= lut->yhi,                              \
+                "approximation input oob: y=%g", y);                        \
+        f64 t = (x - lut->xlo) / (lut->xhi - lut->xlo);                     \
+        f64 s = (y - lut->ylo) / (lut->yhi - lut->ylo);                     \
+        f64 v = kernel(lut_data(lut), (i32)lut->xlen, (i32)lut->ylen, t,    \
+                s);                                                         \
         assert(notnan(v), "approximation input oob: x=%g, y=%g", x, y);     \
         return v;                                                           \
     } while (0)
+#define CEA_2DLOOKUP(name) CEA_2DLOOKUP_(lut_bilinear, name)
 
-f64 cea_Isp(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.018% */
-    /*   rel 0.0518% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_Isp.i"
-    CEA_2DLOOKUP();
+#define CEA_3DLOOKUP(name) do {                                             \
+        const lutTable* lut = lut_get(LUT_##name);                          \
+        COUNT_ADD(cea_lookups, 1);                                          \
+        f64 x = P0_cc*1e-6;                                                 \
+        f64 y = ofr;                                                        \
+        f64 z = AEAT;                                                       \
+        assert(lut->xlo <= x && x <= lut->xhi,                              \
+                "approximation input oob: x=%g", x);                        \
+        assert(lut->ylo <= y && y <= lut->yhi,                              \
+                "approximation input oob: y=%g", y);                        \
+        assert(lut->zlo <= z && z <= lut->zhi,                              \
+                "approximation input oob: z=%g", z);                        \
+        f64 t = (x - lut->xlo) / (lut->xhi - lut->xlo);                     \
+        f64 s = (y - lut->ylo) / (lut->yhi - lut->ylo);                     \
+        f64 r = (z - lut->zlo) / (lut->zhi - lut->zlo);                     \
+        f64 v = lut_trilinear(lut_data(lut), (i32)lut->xlen,                \
+                (i32)lut->ylen, (i32)lut->zlen, t, s, r);                   \
+        assert(notnan(v), "approximation input oob: x=%g, y=%g, z=%g", x,   \
+                y, z);                                                      \
+        return v;                                                           \
+    } while (0)
+
+// Uses the altitude table if loaded, otherwise the sea-level one.
+#define CEA_EXPANDED_LOOKUP(name) do {                                      \
+        if (cea_has_altitude())                                             \
+            CEA_3DLOOKUP(cea3_##name);                                      \
+        (void)AEAT;                                                         \
+        CEA_2DLOOKUP(cea_##name);                                           \
+    } while (0)
+
+i32 cea_has_altitude(void) {
+    // Loaded as a complete set.
+    return lut_has(LUT_cea3_Isp);
+}
+
+
+f64 cea_Isp(f64 P0_cc, f64 ofr, f64 AEAT) {
+    CEA_EXPANDED_LOOKUP(Isp);
 }
 
 
 f64 cea_T0_cc(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0201% */
-    /*   rel 0.0405% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_T_cc.i"
-    CEA_2DLOOKUP();
+    CEA_2DLOOKUP(cea_T_cc);
 }
 
 f64 cea_rho0_cc(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0534% */
-    /*   rel 0.104% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_rho_cc.i"
-    CEA_2DLOOKUP();
+    CEA_2DLOOKUP(cea_rho_cc);
 }
 
 
 f64 cea_Mw_tht(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.00724% */
-    /*   rel 0.016% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_Mw_tht.i"
-    CEA_2DLOOKUP();
+    CEA_2DLOOKUP(cea_Mw_tht);
 }
 
 
 f64 cea_gamma_cc(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0105% */
-    /*   rel 0.138% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_gamma_cc.i"
-    CEA_2DLOOKUP();
+    CEA_2DLOOKUP(cea_gamma_cc);
 }
 
 f64 cea_gamma_tht(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0109% */
-    /*   rel 0.125% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_gamma_tht.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_gamma_lowm(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.00973% */
-    /*   rel 0.108% */
+    CEA_2DLOOKUP(cea_gamma_tht);
+}
+
+f64 cea_gamma_lowm(f64 P0_cc, f64 ofr, f64 AEAT) {
     /* also requires: */
     /*   'M_midm' as: lerp(1, M_exit, 0.1) */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_gamma_lowm.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_gamma_midm(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0764% */
-    /*   rel 0.717% */
+    CEA_EXPANDED_LOOKUP(gamma_lowm);
+}
+
+f64 cea_gamma_midm(f64 P0_cc, f64 ofr, f64 AEAT) {
     /* also requires: */
     /*   'M_midm' as: lerp(1, M_exit, 0.9) */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_gamma_midm.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_gamma_exit(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0826% */
-    /*   rel 0.764% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_gamma_exit.i"
-    CEA_2DLOOKUP();
+    CEA_EXPANDED_LOOKUP(gamma_midm);
+}
+
+f64 cea_gamma_exit(f64 P0_cc, f64 ofr, f64 AEAT) {
+    CEA_EXPANDED_LOOKUP(gamma_exit);
 }
 
 
 f64 cea_cp_cc(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0763% */
-    /*   rel 0.041% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_cp_cc.i"
-    CEA_2DLOOKUP();
+    CEA_2DLOOKUP(cea_cp_cc);
 }
 
 f64 cea_cp_tht(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0877% */
-    /*   rel 0.0459% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_cp_tht.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_cp_lowm(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0894% */
-    /*   rel 0.0481% */
+    CEA_2DLOOKUP(cea_cp_tht);
+}
+
+f64 cea_cp_lowm(f64 P0_cc, f64 ofr, f64 AEAT) {
     /* also requires: */
     /*   'M_midm' as: lerp(1, M_exit, 0.1) */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_cp_lowm.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_cp_midm(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 1.57% */
-    /*   rel 0.686% */
+    CEA_EXPANDED_LOOKUP(cp_lowm);
+}
+
+f64 cea_cp_midm(f64 P0_cc, f64 ofr, f64 AEAT) {
     /* also requires: */
     /*   'M_midm' as: lerp(1, M_exit, 0.9) */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_cp_midm.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_cp_exit(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 2.29% */
-    /*   rel 1.1% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_cp_exit.i"
-    CEA_2DLOOKUP();
+    CEA_EXPANDED_LOOKUP(cp_midm);
+}
+
+f64 cea_cp_exit(f64 P0_cc, f64 ofr, f64 AEAT) {
+    CEA_EXPANDED_LOOKUP(cp_exit);
 }
 
 
 f64 cea_mu_cc(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0147% */
-    /*   rel 0.0353% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_mu_cc.i"
-    CEA_2DLOOKUP();
+    CEA_2DLOOKUP(cea_mu_cc);
 }
 
 f64 cea_mu_tht(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0149% */
-    /*   rel 0.0336% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_mu_tht.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_mu_lowm(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0137% */
-    /*   rel 0.0303% */
+    CEA_2DLOOKUP(cea_mu_tht);
+}
+
+f64 cea_mu_lowm(f64 P0_cc, f64 ofr, f64 AEAT) {
     /* also requires: */
     /*   'M_midm' as: lerp(1, M_exit, 0.1) */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_mu_lowm.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_mu_midm(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0496% */
-    /*   rel 0.0402% */
+    CEA_EXPANDED_LOOKUP(mu_lowm);
+}
+
+f64 cea_mu_midm(f64 P0_cc, f64 ofr, f64 AEAT) {
     /* also requires: */
     /*   'M_midm' as: lerp(1, M_exit, 0.9) */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_mu_midm.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_mu_exit(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0798% */
-    /*   rel 0.0622% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_mu_exit.i"
-    CEA_2DLOOKUP();
+    CEA_EXPANDED_LOOKUP(mu_midm);
+}
+
+f64 cea_mu_exit(f64 P0_cc, f64 ofr, f64 AEAT) {
+    CEA_EXPANDED_LOOKUP(mu_exit);
 }
 
 
 f64 cea_Pr_cc(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0571% */
-    /*   rel 0.254% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_Pr_cc.i"
-    CEA_2DLOOKUP();
+    CEA_2DLOOKUP(cea_Pr_cc);
 }
 
 f64 cea_Pr_tht(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0613% */
-    /*   rel 0.29% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_Pr_tht.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_Pr_lowm(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0587% */
-    /*   rel 0.27% */
+    CEA_2DLOOKUP(cea_Pr_tht);
+}
+
+f64 cea_Pr_lowm(f64 P0_cc, f64 ofr, f64 AEAT) {
     /* also requires: */
     /*   'M_midm' as: lerp(1, M_exit, 0.1) */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_Pr_lowm.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_Pr_midm(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.469% */
-    /*   rel 1.71% */
+    CEA_EXPANDED_LOOKUP(Pr_lowm);
+}
+
+f64 cea_Pr_midm(f64 P0_cc, f64 ofr, f64 AEAT) {
     /* also requires: */
     /*   'M_midm' as: lerp(1, M_exit, 0.9) */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_Pr_midm.i"
-    CEA_2DLOOKUP();
-}
-
-f64 cea_Pr_exit(f64 P0_cc, f64 ofr) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.537% */
-    /*   rel 1.93% */
-    const f64 XLO = 1.0;
-    const f64 XHI = 5.0;
-    const f64 YLO = 1.0;
-    const f64 YHI = 3.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/cea_Pr_exit.i"
-    CEA_2DLOOKUP();
+    CEA_EXPANDED_LOOKUP(Pr_midm);
+}
+
+f64 cea_Pr_exit(f64 P0_cc, f64 ofr, f64 AEAT) {
+    CEA_EXPANDED_LOOKUP(Pr_exit);
 }
 
+#undef CEA_2DLOOKUP_
 #undef CEA_2DLOOKUP
+#undef CEA_3DLOOKUP
+#undef CEA_EXPANDED_LOOKUP
+
+
+// Altitude table is used if `id3d` isnt LUT_COUNT and it is loaded.
+static i64 cea_many_(lutId id, lutId id3d, i64 N, const f64* rstr P0_cc,
+        const f64* rstr ofr, const f64* rstr AEAT, f64* rstr out,
+        u8* rstr oob) {
+    COUNT_ADD(cea_lookups, N);
+    if (id3d == LUT_COUNT || !cea_has_altitude())
+        return lut_bilinear_many(lut_get(id), N, P0_cc, 1e-6, ofr, 1.0, out,
+                oob);
+    return lut_trilinear_many(lut_get(id3d), N, P0_cc, 1e-6, ofr, 1.0, AEAT,
+            1.0, out, oob);
+}
+
+#define CEA_MANY(name, table)                                               \
+    i64 cea_##name##_many(i64 N, const f64* P0_cc, const f64* ofr,          \
+            f64* out, u8* oob) {                                            \
+        return cea_many_(LUT_##table, LUT_COUNT, N, P0_cc, ofr, NULL, out,  \
+                oob);                                                       \
+    }
+#define CEA_EXPANDED_MANY(name)                                             \
+    i64 cea_##name##_many(i64 N, const f64* P0_cc, const f64* ofr,          \
+            const f64* AEAT, f64* out, u8* oob) {                           \
+        return cea_many_(LUT_cea_##name, LUT_cea3_##name, N, P0_cc, ofr,    \
+                AEAT, out, oob);                                            \
+    }
+
+CEA_EXPANDED_MANY(Isp)
+
+CEA_MANY(T0_cc, cea_T_cc)
+CEA_MANY(rho0_cc, cea_rho_cc)
+
+CEA_MANY(Mw_tht, cea_Mw_tht)
+
+CEA_MANY(gamma_cc, cea_gamma_cc)
+CEA_MANY(gamma_tht, cea_gamma_tht)
+CEA_EXPANDED_MANY(gamma_lowm)
+CEA_EXPANDED_MANY(gamma_midm)
+CEA_EXPANDED_MANY(gamma_exit)
+
+CEA_MANY(cp_cc, cea_cp_cc)
+CEA_MANY(cp_tht, cea_cp_tht)
+CEA_EXPANDED_MANY(cp_lowm)
+CEA_EXPANDED_MANY(cp_midm)
+CEA_EXPANDED_MANY(cp_exit)
+
+CEA_MANY(mu_cc, cea_mu_cc)
+CEA_MANY(mu_tht, cea_mu_tht)
+CEA_EXPANDED_MANY(mu_lowm)
+CEA_EXPANDED_MANY(mu_midm)
+CEA_EXPANDED_MANY(mu_exit)
+
+CEA_MANY(Pr_cc, cea_Pr_cc)
+CEA_MANY(Pr_tht, cea_Pr_tht)
+CEA_EXPANDED_MANY(Pr_lowm)
+CEA_EXPANDED_MANY(Pr_midm)
+CEA_EXPANDED_MANY(Pr_exit)
+
+#undef CEA_MANY
+#undef CEA_EXPANDED_MANY
 
 
 
@@ -433,33 +264,51 @@ f64 cea_sample(const ceaFit* fit, f64 M) {
     return ((fit->a*M + fit->b)*M + fit->c)*M + fit->d;
 }
 
-#define cea_make_fit(name) do {                                 \
-        f64 M_lowm = 0.9 + 0.1*M_exit;                          \
-        f64 M_midm = 0.1 + 0.9*M_exit;                          \
-        f64 value_cc = GLUE(cea_, name, _cc)(P0_cc, ofr);       \
-        f64 value_tht = GLUE(cea_, name, _tht)(P0_cc, ofr);     \
-        f64 value_lowm = GLUE(cea_, name, _lowm)(P0_cc, ofr);   \
-        f64 value_midm = GLUE(cea_, name, _midm)(P0_cc, ofr);   \
-        f64 value_exit = GLUE(cea_, name, _exit)(P0_cc, ofr);   \
-        fit_cubic(&fit->a, &fit->b, &fit->c, &fit->d,           \
-                1.0, value_tht,                                 \
-                M_lowm, value_lowm,                             \
-                M_midm, value_midm,                             \
-                M_exit, value_exit                              \
-            );                                                  \
-        fit->M_exit = M_exit;                                   \
-        fit->value_cc = value_cc;                               \
+f64 cea_sample_dM(const ceaFit* fit, f64 M) {
+    if (M < 1.0)
+        return fit->a + fit->b + fit->c + fit->d - fit->value_cc;
+    if (M > fit->M_exit) {
+        f64 M_midm = 0.1 + 0.9*fit->M_exit;
+        f64 value_midm = (((fit->a)*M_midm
+                          + fit->b)*M_midm
+                          + fit->c)*M_midm
+                          + fit->d;
+        f64 value_exit = (((fit->a)*fit->M_exit
+                          + fit->b)*fit->M_exit
+                          + fit->c)*fit->M_exit
+                          + fit->d;
+        return (value_exit - value_midm) / (fit->M_exit - M_midm);
+    }
+    return (3.0*fit->a*M + 2.0*fit->b)*M + fit->c;
+}
+
+#define cea_make_fit(name) do {                                         \
+        f64 M_lowm = 0.9 + 0.1*M_exit;                                  \
+        f64 M_midm = 0.1 + 0.9*M_exit;                                  \
+        f64 value_cc = GLUE(cea_, name, _cc)(P0_cc, ofr);               \
+        f64 value_tht = GLUE(cea_, name, _tht)(P0_cc, ofr);             \
+        f64 value_lowm = GLUE(cea_, name, _lowm)(P0_cc, ofr, AEAT);     \
+        f64 value_midm = GLUE(cea_, name, _midm)(P0_cc, ofr, AEAT);     \
+        f64 value_exit = GLUE(cea_, name, _exit)(P0_cc, ofr, AEAT);     \
+        fit_cubic(&fit->a, &fit->b, &fit->c, &fit->d,                   \
+                1.0, value_tht,                                         \
+                M_lowm, value_lowm,                                     \
+                M_midm, value_midm,                                     \
+                M_exit, value_exit                                      \
+            );                                                          \
+        fit->M_exit = M_exit;                                           \
+        fit->value_cc = value_cc;                                       \
     } while (0)
-void cea_fit_gamma(ceaFit* fit, f64 P0_cc, f64 ofr, f64 M_exit) {
+void cea_fit_gamma(ceaFit* fit, f64 P0_cc, f64 ofr, f64 AEAT, f64 M_exit) {
     cea_make_fit(gamma);
 }
-void cea_fit_cp(ceaFit* fit, f64 P0_cc, f64 ofr, f64 M_exit) {
+void cea_fit_cp(ceaFit* fit, f64 P0_cc, f64 ofr, f64 AEAT, f64 M_exit) {
     cea_make_fit(cp);
 }
-void cea_fit_mu(ceaFit* fit, f64 P0_cc, f64 ofr, f64 M_exit) {
+void cea_fit_mu(ceaFit* fit, f64 P0_cc, f64 ofr, f64 AEAT, f64 M_exit) {
     cea_make_fit(mu);
 }
-void cea_fit_Pr(ceaFit* fit, f64 P0_cc, f64 ofr, f64 M_exit) {
+void cea_fit_Pr(ceaFit* fit, f64 P0_cc, f64 ofr, f64 AEAT, f64 M_exit) {
     cea_make_fit(Pr);
 }
 #undef cea_make_fit
@@ -2,8 +2,15 @@
 #include "br.h"
 
 // NASA-CEA approximations.
+//
+// Properties past the throat additionally depend on the nozzle expansion ratio
+// `AEAT`. These are only tabulated over it when the altitude tables are loaded,
+// otherwise they assume ideal sea-level expansion (and `AEAT` is ignored).
 
-f64 cea_Isp(f64 P0_cc, f64 ofr);
+// Returns non-zero if the approximations support arbitrary expansion ratios.
+i32 cea_has_altitude(void);
+
+f64 cea_Isp(f64 P0_cc, f64 ofr, f64 AEAT);
 
 f64 cea_T0_cc(f64 P0_cc, f64 ofr);
 f64 cea_rho0_cc(f64 P0_cc, f64 ofr);
@@ -12,27 +19,81 @@ f64 cea_Mw_tht(f64 P0_cc, f64 ofr);
 
 f64 cea_gamma_cc(f64 P0_cc, f64 ofr);
 f64 cea_gamma_tht(f64 P0_cc, f64 ofr);
-f64 cea_gamma_lowm(f64 P0_cc, f64 ofr);
-f64 cea_gamma_midm(f64 P0_cc, f64 ofr);
-f64 cea_gamma_exit(f64 P0_cc, f64 ofr);
+f64 cea_gamma_lowm(f64 P0_cc, f64 ofr, f64 AEAT);
+f64 cea_gamma_midm(f64 P0_cc, f64 ofr, f64 AEAT);
+f64 cea_gamma_exit(f64 P0_cc, f64 ofr, f64 AEAT);
 
 f64 cea_cp_cc(f64 P0_cc, f64 ofr);
 f64 cea_cp_tht(f64 P0_cc, f64 ofr);
-f64 cea_cp_lowm(f64 P0_cc, f64 ofr);
-f64 cea_cp_midm(f64 P0_cc, f64 ofr);
-f64 cea_cp_exit(f64 P0_cc, f64 ofr);
+f64 cea_cp_lowm(f64 P0_cc, f64 ofr, f64 AEAT);
+f64 cea_cp_midm(f64 P0_cc, f64 ofr, f64 AEAT);
+f64 cea_cp_exit(f64 P0_cc, f64 ofr, f64 AEAT);
 
 f64 cea_mu_cc(f64 P0_cc, f64 ofr);
 f64 cea_mu_tht(f64 P0_cc, f64 ofr);
-f64 cea_mu_lowm(f64 P0_cc, f64 ofr);
-f64 cea_mu_midm(f64 P0_cc, f64 ofr);
-f64 cea_mu_exit(f64 P0_cc, f64 ofr);
+f64 cea_mu_lowm(f64 P0_cc, f64 ofr, f64 AEAT);
+f64 cea_mu_midm(f64 P0_cc, f64 ofr, f64 AEAT);
+f64 cea_mu_exit(f64 P0_cc, f64 ofr, f64 AEAT);
 
 f64 cea_Pr_cc(f64 P0_cc, f64 ofr);
 f64 cea_Pr_tht(f64 P0_cc, f64 ofr);
-f64 cea_Pr_lowm(f64 P0_cc, f64 ofr);
-f64 cea_Pr_midm(f64 P0_cc, f64 ofr);
-f64 cea_Pr_exit(f64 P0_cc, f64 ofr);
+f64 cea_Pr_lowm(f64 P0_cc, f64 ofr, f64 AEAT);
+f64 cea_Pr_midm(f64 P0_cc, f64 ofr, f64 AEAT);
+f64 cea_Pr_exit(f64 P0_cc, f64 ofr, f64 AEAT);
+
+// Batch versions of the above, evaluating `N` points at once. Rather than
+// asserting, out-of-bounds points give nan and are flagged in `oob` (if
+// non-null). Returns the number of such points.
+
+i64 cea_T0_cc_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+i64 cea_rho0_cc_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+i64 cea_Mw_tht_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+i64 cea_gamma_cc_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+i64 cea_gamma_tht_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+i64 cea_cp_cc_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+i64 cea_cp_tht_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+i64 cea_mu_cc_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+i64 cea_mu_tht_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+i64 cea_Pr_cc_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+i64 cea_Pr_tht_many(i64 N, const f64* P0_cc, const f64* ofr, f64* out,
+        u8* oob);
+
+i64 cea_Isp_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_gamma_lowm_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_gamma_midm_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_gamma_exit_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_cp_lowm_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_cp_midm_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_cp_exit_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_mu_lowm_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_mu_midm_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_mu_exit_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_Pr_lowm_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_Pr_midm_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
+i64 cea_Pr_exit_many(i64 N, const f64* P0_cc, const f64* ofr,
+        const f64* AEAT, f64* out, u8* oob);
 
 
 // Also supply mach-property relations which allow property quering along the
@@ -47,8 +108,10 @@ typedef struct ceaFit {
     f64 d;
 } ceaFit;
 f64 cea_sample(const ceaFit* fit, f64 M);
+// Returns the derivative of `cea_sample` with respect to `M`.
+f64 cea_sample_dM(const ceaFit* fit, f64 M);
 
-void cea_fit_gamma(ceaFit* fit, f64 P0_cc, f64 ofr, f64 M_exit);
-void cea_fit_cp(ceaFit* fit, f64 P0_cc, f64 ofr, f64 M_exit);
-void cea_fit_mu(ceaFit* fit, f64 P0_cc, f64 ofr, f64 M_exit);
-void cea_fit_Pr(ceaFit* fit, f64 P0_cc, f64 ofr, f64 M_exit);
+void cea_fit_gamma(ceaFit* fit, f64 P0_cc, f64 ofr, f64 AEAT, f64 M_exit);
+void cea_fit_cp(ceaFit* fit, f64 P0_cc, f64 ofr, f64 AEAT, f64 M_exit);
+void cea_fit_mu(ceaFit* fit, f64 P0_cc, f64 ofr, f64 AEAT, f64 M_exit);
+void cea_fit_Pr(ceaFit* fit, f64 P0_cc, f64 ofr, f64 AEAT, f64 M_exit);
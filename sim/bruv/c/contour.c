@@ -288,6 +288,102 @@ f64 cnt_r(const Contour* cnt, f64 z) {
     return cnt->r6;
 }
 
+// First and second derivatives of `cnt_r`, segment by segment. The parabola is
+// parametric in `p`, so its derivatives are taken via the chain rule.
+static void cnt_derivs_(const Contour* cnt, f64 z, f64* rstr drdz,
+        f64* rstr d2rdz) {
+    if (z <= cnt->z1) {
+        *drdz = 0.0;
+        *d2rdz = 0.0;
+        return;
+    }
+    if (z <= cnt->z2) {
+        z -= cnt->z1;
+        f64 h = nonhypot(cnt->R_conv, z);
+        *drdz = -z / h;
+        *d2rdz = -sqed(cnt->R_conv) / cbed(h);
+        return;
+    }
+    if (z <= cnt->z3) {
+        *drdz = cnt->tan_phi_conv;
+        *d2rdz = 0.0;
+        return;
+    }
+    if (z <= cnt->z4) {
+        z -= cnt->z4;
+        f64 h = nonhypot(1.5*cnt->R_tht, z);
+        *drdz = z / h;
+        *d2rdz = sqed(1.5*cnt->R_tht) / cbed(h);
+        return;
+    }
+    if (z <= cnt->z5) {
+        z -= cnt->z4;
+        f64 h = nonhypot(0.382*cnt->R_tht, z);
+        *drdz = z / h;
+        *d2rdz = sqed(0.382*cnt->R_tht) / cbed(h);
+        return;
+    }
+    if (z <= cnt->z6) {
+        f64 p;
+        p = 4*cnt->para_az*(cnt->para_cz - z);
+        p = sqrt(cnt->para_bz*cnt->para_bz - p);
+        p = (-cnt->para_bz - p) * 0.5 / cnt->para_az;
+        f64 dzdp = 2*cnt->para_az*p + cnt->para_bz;
+        f64 drdp = 2*cnt->para_ar*p + cnt->para_br;
+        *drdz = drdp / dzdp;
+        *d2rdz = 2*(cnt->para_ar*cnt->para_bz - cnt->para_br*cnt->para_az)
+               / cbed(dzdp);
+        return;
+    }
+    *drdz = 0.0;
+    *d2rdz = 0.0;
+}
+
+f64 cnt_drdz(const Contour* cnt, f64 z) {
+    f64 drdz;
+    f64 d2rdz;
+    cnt_derivs_(cnt, z, &drdz, &d2rdz);
+    return drdz;
+}
+f64 cnt_d2rdz(const Contour* cnt, f64 z) {
+    f64 drdz;
+    f64 d2rdz;
+    cnt_derivs_(cnt, z, &drdz, &d2rdz);
+    return d2rdz;
+}
+f64 cnt_R_curvature(const Contour* cnt, f64 z) {
+    f64 drdz;
+    f64 d2rdz;
+    cnt_derivs_(cnt, z, &drdz, &d2rdz);
+    return cnt_R_curvature_of(drdz, d2rdz);
+}
+f64 cnt_R_curvature_of(f64 drdz, f64 d2rdz) {
+    return (nearzero(d2rdz)) ? INF
+         : cbed(sqrt(1.0 + sqed(drdz))) / abs(d2rdz);
+}
+
+void cnt_derivs_many(const Contour* cnt, i64 N, const f64* rstr z,
+        f64* rstr drdz, f64* rstr d2rdz) {
+    for (i64 i=0; i<N; ++i)
+        cnt_derivs_(cnt, z[i], drdz + i, d2rdz + i);
+}
+
+// Channel widths given the contour radius at `z`, so samplers can share the
+// radius between them.
+static f64 cnt_wi_chnl_at_(const Contour* cnt, f64 z, f64 r) {
+    r += cnt->th_iw + 0.5*cnt_th_chnl(cnt, z);
+    // f64 prop = cnt->prop_chnl;
+    // if (z > cnt->z_tht)
+    //     prop *= lerp(1, 0.5, invlerp(cnt->z_tht, cnt->z_exit, z));
+    return TWOPI*r/cnt->no_chnl * cnt->prop_chnl;
+}
+static f64 cnt_wi_web_at_(const Contour* cnt, f64 z, f64 r) {
+    f64 wi = TWOPI*(r + cnt->th_iw + 0.5*cnt_th_chnl(cnt, z))/cnt->no_chnl
+           - cnt_wi_chnl_at_(cnt, z, r);
+    assert(wi > 0.0, "z=%g", z);
+    return wi;
+}
+
 f64 cnt_th_iw(const Contour* cnt, f64 z) {
     f64 prop = 1.0;
     if (z > cnt->z_tht)
@@ -310,17 +406,10 @@ f64 cnt_th_chnl(const Contour* cnt, f64 z) {
 }
 
 f64 cnt_wi_web(const Contour* cnt, f64 z) {
-    f64 r = cnt_r(cnt, z) + cnt->th_iw + 0.5*cnt_th_chnl(cnt, z);
-    f64 wi = TWOPI*r/cnt->no_chnl - cnt_wi_chnl(cnt, z);
-    assert(wi > 0.0, "z=%g", z);
-    return wi;
+    return cnt_wi_web_at_(cnt, z, cnt_r(cnt, z));
 }
 f64 cnt_wi_chnl(const Contour* cnt, f64 z) {
-    f64 r = cnt_r(cnt, z) + cnt->th_iw + 0.5*cnt_th_chnl(cnt, z);
-    // f64 prop = cnt->prop_chnl;
-    // if (z > cnt->z_tht)
-    //     prop *= lerp(1, 0.5, invlerp(cnt->z_tht, cnt->z_exit, z));
-    return TWOPI*r/cnt->no_chnl * cnt->prop_chnl;
+    return cnt_wi_chnl_at_(cnt, z, cnt_r(cnt, z));
 }
 
 f64 cnt_psi_chnl(const Contour* cnt, f64 z) {
@@ -328,6 +417,94 @@ f64 cnt_psi_chnl(const Contour* cnt, f64 z) {
 }
 
 
+// `cnt_r` for four points all within segment `seg` (counting from 0, in the
+// order they're tested in `cnt_r`). Identical arithmetic to the scalar form.
+static ALWAYSINLINE dvec4 cnt_r_seg_(const Contour* cnt, i32 seg, dvec4 z) {
+    switch (seg) {
+        case 0:
+            return dvec4(cnt->r0);
+        case 1:
+            z -= cnt->z1;
+            return cnt->r1 - cnt->R_conv + sqrt(sqed(cnt->R_conv) - z*z);
+        case 2:
+            z -= cnt->z3;
+            return cnt->tan_phi_conv*z + cnt->r3;
+        case 3:
+            z -= cnt->z4;
+            return 2.5*cnt->R_tht - sqrt(sqed(1.5*cnt->R_tht) - z*z);
+        case 4:
+            z -= cnt->z4;
+            return 1.382*cnt->R_tht - sqrt(sqed(0.382*cnt->R_tht) - z*z);
+        case 5: {
+            dvec4 p;
+            p = 4*cnt->para_az*(cnt->para_cz - z);
+            p = sqrt(cnt->para_bz*cnt->para_bz - p);
+            p = (-cnt->para_bz - p) * 0.5 / cnt->para_az;
+            return (cnt->para_ar*p + cnt->para_br)*p + cnt->para_cr;
+        }
+    }
+    return dvec4(cnt->r6);
+}
+
+void cnt_sample_many(const Contour* cnt, i64 N, const f64* rstr z,
+        const cntSamples* out) {
+    assert(out->r, "radius output is required");
+    i32 geometry = out->th_iw || out->helix_angle || out->th_chnl
+                || out->wi_web || out->wi_chnl || out->psi_chnl;
+    f64 bounds[7] = {
+        cnt->z1, cnt->z2, cnt->z3, cnt->z4, cnt->z5, cnt->z6, INF
+    };
+    // Since `z` is ascending, each segment owns a contiguous run of it, found
+    // by advancing a cursor rather than testing every point against every
+    // segment.
+    i64 i = 0;
+    for (i32 seg=0; seg<7; ++seg) {
+        i64 end = i;
+        while (end < N && z[end] <= bounds[seg])
+            ++end;
+
+        i64 j = i;
+        for (; j + 4 <= end; j += 4) {
+            dvec4 rs = cnt_r_seg_(cnt, seg, dvec4_from_array(z + j));
+            __builtin_memcpy(out->r + j, &rs, sizeof(rs));
+        }
+        if (j < end) {
+            // Pad the partial block with its last point.
+            dvec4 zs;
+            for (i32 k=0; k<4; ++k)
+                zs[k] = z[min(j + k, end - 1)];
+            dvec4 rs = cnt_r_seg_(cnt, seg, zs);
+            for (i64 k=j; k<end; ++k)
+                out->r[k] = rs[k - j];
+        }
+
+        for (i64 j=i; j<end && geometry; ++j) {
+            f64 helix = cnt_helix_angle(cnt, z[j]);
+            if (out->th_iw)
+                out->th_iw[j] = cnt_th_iw(cnt, z[j]);
+            if (out->helix_angle)
+                out->helix_angle[j] = helix;
+            if (out->th_chnl)
+                out->th_chnl[j] = cnt_th_chnl(cnt, z[j]);
+            if (out->wi_web)
+                out->wi_web[j] = cnt_wi_web_at_(cnt, z[j], out->r[j]);
+            f64 wi_chnl = cnt_wi_chnl_at_(cnt, z[j], out->r[j]);
+            if (out->wi_chnl)
+                out->wi_chnl[j] = wi_chnl;
+            if (out->psi_chnl)
+                out->psi_chnl[j] = wi_chnl * cos(helix);
+        }
+
+        i = end;
+    }
+    assert(i == N, "z must be ascending and non-nan");
+}
+
+void cnt_r_many(const Contour* cnt, i64 N, const f64* rstr z, f64* rstr r) {
+    cnt_sample_many(cnt, N, z, &(cntSamples){ .r = r });
+}
+
+
 f64 cnt_V_subsonic(const Contour* cnt) {
     f64 V = 0.0;
 
@@ -377,3 +554,124 @@ f64 cnt_V_subsonic(const Contour* cnt) {
 
     return V;
 }
+
+
+
+// Allocates the arrays of `smp`, for the caller to place the stations in `z`.
+static void cnt_sampler_alloc_(ContourSampler* smp, i32 N) {
+    assert(N > 1, "too few stations: N=%d", N);
+    f64* data = malloc(9 * N * sizeof(f64));
+    assert(data, "failed to allocate contour sampler");
+    smp->N = N;
+    smp->z = data + 0*N;
+    smp->r = data + 1*N;
+    smp->ell = data + 2*N;
+    smp->th_iw = data + 3*N;
+    smp->helix_angle = data + 4*N;
+    smp->th_chnl = data + 5*N;
+    smp->wi_web = data + 6*N;
+    smp->wi_chnl = data + 7*N;
+    smp->psi_chnl = data + 8*N;
+}
+// Fills in everything else at the stations.
+static void cnt_sampler_fill_(ContourSampler* smp, const Contour* cnt) {
+    i32 N = smp->N;
+    cnt_sample_many(cnt, N, smp->z, &(cntSamples){
+            .r = smp->r,
+            .th_iw = smp->th_iw,
+            .helix_angle = smp->helix_angle,
+            .th_chnl = smp->th_chnl,
+            .wi_web = smp->wi_web,
+            .wi_chnl = smp->wi_chnl,
+            .psi_chnl = smp->psi_chnl,
+        });
+    smp->ell[0] = 0.0;
+    for (i32 i=1; i<N; ++i)
+        smp->ell[i] = smp->ell[i - 1] + hypot(smp->r[i] - smp->r[i - 1],
+                                              smp->z[i] - smp->z[i - 1]);
+}
+
+ContourSampler* init_cnt_sampler(ContourSampler* smp, const Contour* cnt,
+        i32 N) {
+    cnt_sampler_alloc_(smp, N);
+    for (i32 i=0; i<N; ++i)
+        smp->z[i] = lerpidx(0.0, cnt->z_exit, i, N);
+    cnt_sampler_fill_(smp, cnt);
+    return smp;
+}
+
+ContourSampler* init_cnt_sampler_clustered(ContourSampler* smp,
+        const Contour* cnt, i32 N) {
+    cnt_sampler_alloc_(smp, N);
+
+    // Tabulate the station density finely (and uniformly), integrate it over
+    // the arc length, then place the stations at even steps of that integral.
+    enum { FINE = 2048 };
+    f64* fine = malloc(5 * FINE * sizeof(f64));
+    assert(fine, "failed to allocate contour sampler");
+    f64* z = fine + 0*FINE;
+    f64* r = fine + 1*FINE;
+    f64* drdz = fine + 2*FINE;
+    f64* d2rdz = fine + 3*FINE;
+    f64* W = fine + 4*FINE;
+    for (i32 j=0; j<FINE; ++j)
+        z[j] = lerpidx(0.0, cnt->z_exit, j, FINE);
+    cnt_r_many(cnt, FINE, z, r);
+    cnt_derivs_many(cnt, FINE, z, drdz, d2rdz);
+
+    f64 ell_tht = 0.0;
+    f64 ell = 0.0;
+    for (i32 j=1; j<FINE; ++j) {
+        ell += hypot(r[j] - r[j - 1], z[j] - z[j - 1]);
+        if (z[j] <= cnt->z_tht)
+            ell_tht = ell;
+    }
+    ell = 0.0;
+    f64 prev_m = 0.0;
+    for (i32 j=0; j<FINE; ++j) {
+        f64 Dell = (j == 0) ? 0.0 : hypot(r[j] - r[j - 1], z[j] - z[j - 1]);
+        ell += Dell;
+        f64 curvature = 1.0 / cnt_R_curvature_of(drdz[j], d2rdz[j]);
+        f64 m = 1.0
+              + CNT_CLUSTER_CURVATURE * cnt->R_tht * curvature
+              + CNT_CLUSTER_THROAT * cnt->R_tht
+                                   / (cnt->R_tht + abs(ell - ell_tht));
+        W[j] = (j == 0) ? 0.0 : W[j - 1] + 0.5*(prev_m + m)*Dell;
+        prev_m = m;
+    }
+
+    // Invert the integral with a cursor, since both it and the targets are
+    // ascending.
+    smp->z[0] = 0.0;
+    i32 j = 0;
+    for (i32 i=1; i<N - 1; ++i) {
+        f64 target = lerpidx(0.0, W[FINE - 1], i, N);
+        while (W[j + 1] < target)
+            ++j;
+        smp->z[i] = lerp(z[j], z[j + 1], invlerp(W[j], W[j + 1], target));
+    }
+    smp->z[N - 1] = cnt->z_exit;
+    free(fine);
+
+    cnt_sampler_fill_(smp, cnt);
+    return smp;
+}
+
+i32 cnt_sampler_find(const ContourSampler* smp, f64 z, f64* t) {
+    i32 lo = 0;
+    i32 hi = smp->N - 1;
+    while (hi - lo > 1) {
+        i32 mid = (lo + hi) / 2;
+        if (smp->z[mid] <= z)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    *t = min(max(invlerp(smp->z[lo], smp->z[hi], z), 0.0), 1.0);
+    return lo;
+}
+
+void free_cnt_sampler(ContourSampler* smp) {
+    free(smp->z);
+    *smp = (ContourSampler){0};
+}
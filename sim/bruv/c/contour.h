@@ -61,4 +61,66 @@ f64 cnt_wi_web(const Contour* cnt, f64 z);
 f64 cnt_wi_chnl(const Contour* cnt, f64 z);
 f64 cnt_psi_chnl(const Contour* cnt, f64 z);
 
+// Batched evaluation over the `N` ascending points `z`. Each output (other than
+// the radius) may be null to skip it. Points are evaluated four at a time,
+// segment by segment.
+typedef struct cntSamples {
+    f64* r;
+    f64* th_iw;
+    f64* helix_angle;
+    f64* th_chnl;
+    f64* wi_web;
+    f64* wi_chnl;
+    f64* psi_chnl;
+} cntSamples;
+void cnt_sample_many(const Contour* cnt, i64 N, const f64* rstr z,
+        const cntSamples* out);
+void cnt_r_many(const Contour* cnt, i64 N, const f64* rstr z, f64* rstr r);
+
+// Exact slope and second derivative of `cnt_r` (taken within whichever segment
+// contains `z`), and the resulting radius of curvature of the wall in the
+// meridional plane (inf where straight).
+f64 cnt_drdz(const Contour* cnt, f64 z);
+f64 cnt_d2rdz(const Contour* cnt, f64 z);
+f64 cnt_R_curvature(const Contour* cnt, f64 z);
+f64 cnt_R_curvature_of(f64 drdz, f64 d2rdz);
+// Batched form of `cnt_drdz` and `cnt_d2rdz` over the `N` points `z`.
+void cnt_derivs_many(const Contour* cnt, i64 N, const f64* rstr z,
+        f64* rstr drdz, f64* rstr d2rdz);
+
 f64 cnt_V_subsonic(const Contour* cnt); // volume up-to throat.
+
+
+// The contour and channel geometry evaluated once at a set of stations, so the
+// marches over it (which are repeated many times per simulation) don't have to.
+// Stored as parallel arrays, all in one allocation.
+typedef struct ContourSampler {
+    i32 N; // number of stations.
+    f64* z;
+    f64* r;
+    f64* ell; // arc length along the wall from the injector face.
+    f64* th_iw;
+    f64* helix_angle;
+    f64* th_chnl;
+    f64* wi_web;
+    f64* wi_chnl;
+    f64* psi_chnl;
+} ContourSampler;
+// Samples `cnt` at `N` stations evenly spaced over `0..z_exit`. Must be
+// released with `free_cnt_sampler`.
+ContourSampler* init_cnt_sampler(ContourSampler* smp, const Contour* cnt,
+        i32 N);
+// Samples `cnt` at `N` stations spaced along the wall rather than the axis, and
+// clustered towards the bends and the throat (where the heat flux peaks).
+// Stations are evenly spaced in the integral over arc length of the density
+// `1 + a*R_tht*curvature + b*R_tht/(R_tht + d)`, where `d` is the arc length
+// to the throat.
+#define CNT_CLUSTER_CURVATURE (0.1) // a
+#define CNT_CLUSTER_THROAT (0.2) // b
+ContourSampler* init_cnt_sampler_clustered(ContourSampler* smp,
+        const Contour* cnt, i32 N);
+void free_cnt_sampler(ContourSampler* smp);
+
+// Returns the index `k` of the station interval `k..k+1` of `smp` containing
+// `z`, with `t` set to the fraction along it. Both are clamped to the ends.
+i32 cnt_sampler_find(const ContourSampler* smp, f64 z, f64* t);
@@ -1,7 +1,9 @@
 #include "ethanol.h"
 
 #include "assertion.h"
+#include "lut.h"
 #include "maths.h"
+#include "profile.h"
 
 
 // function of pressure to avoid gas+super critical regions.
@@ -11,98 +13,90 @@ f64 ethanol_max_T(f64 P) {
 }
 
 
-#define ETHANOL_2DLOOKUP() do {                                                 \
+#define ETHANOL_2DLOOKUP_(kernel, name) do {                                    \
+        const lutTable* lut = lut_get(LUT_##name);                              \
+        COUNT_ADD(ethanol_lookups, 1);                                          \
         f64 x = T;                                                              \
         f64 y = P*1e-6;                                                         \
-        assert(XLO <= x && x <= XHI, "approximation input oob: x=%g", x);       \
-        assert(YLO <= y && y <= YHI, "approximation input oob: y=%g", y);       \
+        assert(lut->xlo <= x && x <= lut->xhi,                                  \
+                "approximation input oob: x=%g", x);                            \
+        assert(lut->ylo <= y && y <= lut->yhi,                                  \
+                "approximation input oob: y=%g", y);                            \
         assert(x <= 18.75 * y + 410.6, "approximation input oob: x=%g, y=%g",   \
                 x, y);                                                          \
-        f64 t = (x - XLO) / (XHI - XLO);                                        \
-        f64 s = (y - YLO) / (YHI - YLO);                                        \
-        t *= XLEN - 1;                                                          \
-        s *= YLEN - 1;                                                          \
-        i32 i = min(max((i32)t, 0), XLEN - 2);                                  \
-        i32 j = min(max((i32)s, 0), YLEN - 2);                                  \
-        t -= i;                                                                 \
-        s -= j;                                                                 \
-        f64 v00 = tbl[YLEN*i + j];                                              \
-        f64 v01 = tbl[YLEN*i + j + 1];                                          \
-        f64 v10 = tbl[YLEN*(i + 1) + j];                                        \
-        f64 v11 = tbl[YLEN*(i + 1) + j + 1];                                    \
-        f64 v0 = v00 + s*(v01 - v00);                                           \
-        f64 v1 = v10 + s*(v11 - v10);                                           \
-        f64 v = v0 + t*(v1 - v0);                                               \
+        f64 t = (x - lut->xlo) / (lut->xhi - lut->xlo);                         \
+        f64 s = (y - lut->ylo) / (lut->yhi - lut->ylo);                         \
+        f64 v = kernel(lut_data(lut), (i32)lut->xlen, (i32)lut->ylen, t,        \
+                s);                                                             \
         assert(notnan(v), "approximation nan output: x=%g, y=%g", x, y);        \
         return v;                                                               \
     } while (0)
+#define ETHANOL_2DLOOKUP(name) ETHANOL_2DLOOKUP_(lut_bilinear, name)
 
 f64 ethanol_rho(f64 T, f64 P) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.131% */
-    /*   rel 0.177% */
     /* also requires: */
     /*   x <= 16.5 * y + 409.9 */
-    const f64 XLO = 250.0;
-    const f64 XHI = 500.0;
-    const f64 YLO = 2.0;
-    const f64 YHI = 7.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/ethanol_rho.i"
-    ETHANOL_2DLOOKUP();
+    ETHANOL_2DLOOKUP(ethanol_rho);
 }
 
 f64 ethanol_cp(f64 T, f64 P) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 1.24% */
-    /*   rel 1.66% */
     /* also requires: */
     /*   x <= 16.5 * y + 409.9 */
-    const f64 XLO = 250.0;
-    const f64 XHI = 500.0;
-    const f64 YLO = 2.0;
-    const f64 YHI = 7.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/ethanol_cp.i"
-    ETHANOL_2DLOOKUP();
+    ETHANOL_2DLOOKUP(ethanol_cp);
 }
 
 f64 ethanol_mu(f64 T, f64 P) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.161% */
-    /*   rel 0.0925% */
     /* also requires: */
     /*   x <= 16.5 * y + 409.9 */
-    const f64 XLO = 250.0;
-    const f64 XHI = 500.0;
-    const f64 YLO = 2.0;
-    const f64 YHI = 7.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/ethanol_mu.i"
-    ETHANOL_2DLOOKUP();
+    ETHANOL_2DLOOKUP(ethanol_mu);
 }
 
 f64 ethanol_k(f64 T, f64 P) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.0629% */
-    /*   rel 0.183% */
     /* also requires: */
     /*   x <= 16.5 * y + 409.9 */
-    const f64 XLO = 250.0;
-    const f64 XHI = 500.0;
-    const f64 YLO = 2.0;
-    const f64 YHI = 7.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/ethanol_k.i"
-    ETHANOL_2DLOOKUP();
+    ETHANOL_2DLOOKUP(ethanol_k);
 }
 
+#undef ETHANOL_2DLOOKUP_
 #undef ETHANOL_2DLOOKUP
+
+
+i64 ethanol_props_many(i64 N, const f64* T, const f64* P, f64* rho, f64* cp,
+        f64* mu, f64* k, u8* oob) {
+    f64* outs[4] = { rho, cp, mu, k };
+    const lutTable* luts[4] = {
+        lut_get(LUT_ethanol_rho), lut_get(LUT_ethanol_cp),
+        lut_get(LUT_ethanol_mu), lut_get(LUT_ethanol_k),
+    };
+    i64 count = 0;
+    // Chunked so the mask can live on the stack.
+    for (i64 start=0; start<N; start+=64) {
+        i64 n = min(N - start, 64);
+        u8 bad[64];
+        u8 mask[64];
+        for (i64 i=0; i<n; ++i)
+            bad[i] = !(T[start + i] <= 16.5e-6*P[start + i] + 409.9);
+        for (i32 p=0; p<4; ++p) {
+            if (outs[p] == NULL)
+                continue;
+            COUNT_ADD(ethanol_lookups, n);
+            lut_bilinear_many(luts[p], n, T + start, 1.0, P + start, 1e-6,
+                    outs[p] + start, mask);
+            for (i64 i=0; i<n; ++i)
+                bad[i] |= mask[i];
+        }
+        // A point is either entirely valid or entirely nan.
+        for (i64 i=0; i<n; ++i) {
+            count += bad[i];
+            if (oob != NULL)
+                oob[start + i] = bad[i];
+            if (!bad[i])
+                continue;
+            for (i32 p=0; p<4; ++p) {
+                if (outs[p] != NULL)
+                    outs[p][start + i] = NAN;
+            }
+        }
+    }
+    return count;
+}
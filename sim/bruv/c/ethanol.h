@@ -12,3 +12,10 @@ f64 ethanol_rho(f64 T, f64 P);
 f64 ethanol_cp(f64 T, f64 P);
 f64 ethanol_mu(f64 T, f64 P);
 f64 ethanol_k(f64 T, f64 P);
+
+// Batch evaluation of all the above properties at `N` points. Rather than
+// asserting, out-of-bounds points give nan and are flagged in `oob` (if
+// non-null). Returns the number of such points. Any output may be null to skip
+// it.
+i64 ethanol_props_many(i64 N, const f64* T, const f64* P, f64* rho, f64* cp,
+        f64* mu, f64* k, u8* oob);
@@ -1,7 +1,9 @@
 #include "ipa.h"
 
 #include "assertion.h"
+#include "lut.h"
 #include "maths.h"
+#include "profile.h"
 
 
 // function of pressure to avoid gas+super critical regions.
@@ -11,98 +13,90 @@ f64 ipa_max_T(f64 P) {
 }
 
 
-#define IPA_2DLOOKUP() do {                                                     \
+#define IPA_2DLOOKUP_(kernel, name) do {                                        \
+        const lutTable* lut = lut_get(LUT_##name);                              \
+        COUNT_ADD(ipa_lookups, 1);                                              \
         f64 x = T;                                                              \
         f64 y = P*1e-6;                                                         \
-        assert(XLO <= x && x <= XHI, "approximation input oob: x=%g", x);       \
-        assert(YLO <= y && y <= YHI, "approximation input oob: y=%g", y);       \
+        assert(lut->xlo <= x && x <= lut->xhi,                                  \
+                "approximation input oob: x=%g", x);                            \
+        assert(lut->ylo <= y && y <= lut->yhi,                                  \
+                "approximation input oob: y=%g", y);                            \
         assert(x <= 18.75 * y + 410.6, "approximation input oob: x=%g, y=%g",   \
                 x, y);                                                          \
-        f64 t = (x - XLO) / (XHI - XLO);                                        \
-        f64 s = (y - YLO) / (YHI - YLO);                                        \
-        t *= XLEN - 1;                                                          \
-        s *= YLEN - 1;                                                          \
-        i32 i = min(max((i32)t, 0), XLEN - 2);                                  \
-        i32 j = min(max((i32)s, 0), YLEN - 2);                                  \
-        t -= i;                                                                 \
-        s -= j;                                                                 \
-        f64 v00 = tbl[YLEN*i + j];                                              \
-        f64 v01 = tbl[YLEN*i + j + 1];                                          \
-        f64 v10 = tbl[YLEN*(i + 1) + j];                                        \
-        f64 v11 = tbl[YLEN*(i + 1) + j + 1];                                    \
-        f64 v0 = v00 + s*(v01 - v00);                                           \
-        f64 v1 = v10 + s*(v11 - v10);                                           \
-        f64 v = v0 + t*(v1 - v0);                                               \
+        f64 t = (x - lut->xlo) / (lut->xhi - lut->xlo);                         \
+        f64 s = (y - lut->ylo) / (lut->yhi - lut->ylo);                         \
+        f64 v = kernel(lut_data(lut), (i32)lut->xlen, (i32)lut->ylen, t,        \
+                s);                                                             \
         assert(notnan(v), "approximation nan output: x=%g, y=%g", x, y);        \
         return v;                                                               \
     } while (0)
+#define IPA_2DLOOKUP(name) IPA_2DLOOKUP_(lut_bilinear, name)
 
 f64 ipa_rho(f64 T, f64 P) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.366% */
-    /*   rel 0.458% */
     /* also requires: */
     /*   x <= 18.75 * y + 410.6 */
-    const f64 XLO = 250.0;
-    const f64 XHI = 500.0;
-    const f64 YLO = 2.0;
-    const f64 YHI = 7.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/ipa_rho.i"
-    IPA_2DLOOKUP();
+    IPA_2DLOOKUP(ipa_rho);
 }
 
 f64 ipa_cp(f64 T, f64 P) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.00939% */
-    /*   rel 0.0072% */
     /* also requires: */
     /*   x <= 18.75 * y + 410.6 */
-    const f64 XLO = 250.0;
-    const f64 XHI = 500.0;
-    const f64 YLO = 2.0;
-    const f64 YHI = 7.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/ipa_cp.i"
-    IPA_2DLOOKUP();
+    IPA_2DLOOKUP(ipa_cp);
 }
 
 f64 ipa_mu(f64 T, f64 P) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.239% */
-    /*   rel 0.222% */
     /* also requires: */
     /*   x <= 18.75 * y + 410.6 */
-    const f64 XLO = 250.0;
-    const f64 XHI = 500.0;
-    const f64 YLO = 2.0;
-    const f64 YHI = 7.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/ipa_mu.i"
-    IPA_2DLOOKUP();
+    IPA_2DLOOKUP(ipa_mu);
 }
 
 f64 ipa_k(f64 T, f64 P) {
-    /* evenly-spaced flattened (C-ordered) 2D LUT */
-    /* max error of: */
-    /*   abs 0.000662% */
-    /*   rel 0.00209% */
     /* also requires: */
     /*   x <= 18.75 * y + 410.6 */
-    const f64 XLO = 250.0;
-    const f64 XHI = 500.0;
-    const f64 YLO = 2.0;
-    const f64 YHI = 7.0;
-    enum { XLEN = 80,
-           YLEN = 80, };
-    #include "tbl/ipa_k.i"
-    IPA_2DLOOKUP();
+    IPA_2DLOOKUP(ipa_k);
 }
 
+#undef IPA_2DLOOKUP_
 #undef IPA_2DLOOKUP
+
+
+i64 ipa_props_many(i64 N, const f64* T, const f64* P, f64* rho, f64* cp,
+        f64* mu, f64* k, u8* oob) {
+    f64* outs[4] = { rho, cp, mu, k };
+    const lutTable* luts[4] = {
+        lut_get(LUT_ipa_rho), lut_get(LUT_ipa_cp),
+        lut_get(LUT_ipa_mu), lut_get(LUT_ipa_k),
+    };
+    i64 count = 0;
+    // Chunked so the mask can live on the stack.
+    for (i64 start=0; start<N; start+=64) {
+        i64 n = min(N - start, 64);
+        u8 bad[64];
+        u8 mask[64];
+        for (i64 i=0; i<n; ++i)
+            bad[i] = !(T[start + i] <= 18.75e-6*P[start + i] + 410.6);
+        for (i32 p=0; p<4; ++p) {
+            if (outs[p] == NULL)
+                continue;
+            COUNT_ADD(ipa_lookups, n);
+            lut_bilinear_many(luts[p], n, T + start, 1.0, P + start, 1e-6,
+                    outs[p] + start, mask);
+            for (i64 i=0; i<n; ++i)
+                bad[i] |= mask[i];
+        }
+        // A point is either entirely valid or entirely nan.
+        for (i64 i=0; i<n; ++i) {
+            count += bad[i];
+            if (oob != NULL)
+                oob[start + i] = bad[i];
+            if (!bad[i])
+                continue;
+            for (i32 p=0; p<4; ++p) {
+                if (outs[p] != NULL)
+                    outs[p][start + i] = NAN;
+            }
+        }
+    }
+    return count;
+}
@@ -0,0 +1,411 @@
+#include "lut.h"
+
+#include "assertion.h"
+#include "maths.h"
+
+
+static_assert(sizeof(lutFileHeader) == 32);
+static_assert(sizeof(lutTable) == 128);
+
+
+#ifndef _WIN32
+// posix function expose without the import cause fuck that.
+i32 open(const char* path, i32 flags, ...);
+i32 close(i32 fd);
+i64 lseek(i32 fd, i64 offset, i32 whence);
+void* mmap(void* addr, u64 length, i32 prot, i32 flags, i32 fd, i64 offset);
+i32 munmap(void* addr, u64 length);
+static void* map_file_(const char* path, i64* rstr size) {
+    i32 fd = open(path, 0 /* O_RDONLY */);
+    assert(fd >= 0, "failed to open table file: %s", path);
+    *size = lseek(fd, 0, SEEK_END);
+    if (*size <= 0) {
+        close(fd);
+        assert(0, "failed to size table file: %s", path);
+    }
+    void* map = mmap(NULL, (u64)*size, 1 /* PROT_READ */, 1 /* MAP_SHARED */,
+            fd, 0);
+    close(fd); // mapping holds its own reference.
+    assert(map != (void*)((i64)-1) /* MAP_FAILED */,
+            "failed to map table file: %s", path);
+    return map;
+}
+static void unmap_file_(void* map, i64 size) {
+    munmap(map, (u64)size);
+}
+#else
+// windows function expose without the import cause fuck that.
+__declspec(dllimport) void* __stdcall CreateFileA(const char* path, u32 access,
+        u32 share, void* security, u32 disposition, u32 flags, void* template);
+__declspec(dllimport) i32 __stdcall GetFileSizeEx(void* hnd, i64* size);
+__declspec(dllimport) void* __stdcall CreateFileMappingA(void* hnd,
+        void* security, u32 protect, u32 size_hi, u32 size_lo, const char* name);
+__declspec(dllimport) void* __stdcall MapViewOfFile(void* hnd, u32 access,
+        u32 offset_hi, u32 offset_lo, u64 size);
+__declspec(dllimport) i32 __stdcall UnmapViewOfFile(const void* map);
+__declspec(dllimport) i32 __stdcall CloseHandle(void* hnd);
+static void* map_file_(const char* path, i64* rstr size) {
+    void* hnd = CreateFileA(path, 0x80000000U /* GENERIC_READ */,
+            0x1 /* FILE_SHARE_READ */, NULL, 3 /* OPEN_EXISTING */,
+            0x80 /* FILE_ATTRIBUTE_NORMAL */, NULL);
+    assert(hnd != (void*)((i64)-1) /* INVALID_HANDLE_VALUE */,
+            "failed to open table file: %s", path);
+    if (!GetFileSizeEx(hnd, size) || *size <= 0) {
+        CloseHandle(hnd);
+        assert(0, "failed to size table file: %s", path);
+    }
+    void* mapping = CreateFileMappingA(hnd, NULL, 0x2 /* PAGE_READONLY */, 0, 0,
+            NULL);
+    CloseHandle(hnd); // mapping holds its own reference.
+    assert(mapping != NULL, "failed to map table file: %s", path);
+    void* map = MapViewOfFile(mapping, 0x4 /* FILE_MAP_READ */, 0, 0, 0);
+    CloseHandle(mapping); // view holds its own reference.
+    assert(map != NULL, "failed to map table file: %s", path);
+    return map;
+}
+static void unmap_file_(void* map, i64 size) {
+    (void)size;
+    UnmapViewOfFile(map);
+}
+#endif
+
+
+static const char* const lut_names_[LUT_COUNT] = {
+    #define X(name) [LUT_##name] = #name,
+    LUT_TABLES
+    LUT_TABLES_3D
+    #undef X
+};
+
+static i32 lut_is_3d_(i32 id) {
+    switch ((lutId)id) {
+        #define X(name) case LUT_##name:
+        LUT_TABLES
+        #undef X
+            return 0;
+        #define X(name) case LUT_##name:
+        LUT_TABLES_3D
+        #undef X
+            return 1;
+        case LUT_COUNT:
+            break;
+    }
+    assert(0, "invalid table id: %d", id);
+    return 0;
+}
+
+// Note the mapping is never released once loaded, tables live for the whole
+// process.
+static const u8* lut_base_ = NULL;
+static const lutTable* lut_tables_[LUT_COUNT];
+
+static i32 name_eq_(const char* a, const char* b) {
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+void lut_load(const char* path) {
+    if (lut_base_ != NULL)
+        return; // only ever loaded once.
+
+    i64 size;
+    void* map = map_file_(path, &size);
+    const u8* base = map;
+
+    // Unmaps the file before failing, so a bad file doesn't leak its mapping.
+    // Note the messages must therefore only reference copies of its contents.
+    #define LUT_CHECK_(x, fmt_and_args...) do {                                \
+            if (!(x)) {                                                        \
+                unmap_file_(map, size);                                        \
+                assert(0, fmt_and_args);                                       \
+            }                                                                  \
+        } while (0)
+
+    LUT_CHECK_(size >= sizeof(lutFileHeader), "invalid table file: %s", path);
+    lutFileHeader head = *(const lutFileHeader*)(const void*)base;
+    LUT_CHECK_(head.magic == LUT_MAGIC, "invalid table file: %s", path);
+    LUT_CHECK_(head.version == LUT_VERSION, "table file version mismatch, "
+            "expected %d got %lld: %s", LUT_VERSION, head.version, path);
+    LUT_CHECK_(head.size == size, "truncated table file: %s", path);
+    LUT_CHECK_(0 <= head.count && head.count <= (size - sizeof(lutFileHeader))
+                                                 / sizeof(lutTable),
+            "invalid table file: %s", path);
+
+    const lutTable* tables = (const void*)(base + sizeof(lutFileHeader));
+    const lutTable* found[LUT_COUNT] = {0};
+    for (i64 i=0; i<head.count; ++i) {
+        lutTable lut = tables[i];
+        LUT_CHECK_(lut.name[numel(lut.name) - 1] == '\0',
+                "invalid table file, entry %lld name: %s", i, path);
+        LUT_CHECK_(lut.xlen >= 2 && lut.ylen >= 2 && lut.zlen >= 1,
+                "invalid table file, '%s' shape: %s", lut.name, path);
+        LUT_CHECK_(lut.xlo < lut.xhi && lut.ylo < lut.yhi
+            && (lut.zlen == 1 || lut.zlo < lut.zhi),
+                "invalid table file, '%s' bounds: %s", lut.name, path);
+        LUT_CHECK_(lut.offset % 64 == 0 && lut.offset > 0
+            && lut.offset + lut.xlen*lut.ylen*lut.zlen*sizeof(f32) <= size,
+                "invalid table file, '%s' offset: %s", lut.name, path);
+        for (i32 id=0; id<LUT_COUNT; ++id) {
+            if (name_eq_(lut.name, lut_names_[id]))
+                found[id] = tables + i;
+        }
+    }
+    i32 count_3d = 0;
+    for (i32 id=0; id<LUT_COUNT; ++id) {
+        i32 is_3d = lut_is_3d_(id);
+        count_3d += is_3d && found[id] != NULL;
+        LUT_CHECK_(is_3d || found[id] != NULL, "table file missing '%s': %s",
+                lut_names_[id], path);
+        if (found[id] == NULL)
+            continue;
+        LUT_CHECK_((found[id]->zlen >= 2) == is_3d, "table file '%s' should be "
+                "%dD: %s", lut_names_[id], 2 + is_3d, path);
+    }
+    // Optional tables must come as a complete set.
+    for (i32 id=0; id<LUT_COUNT; ++id) {
+        LUT_CHECK_(!lut_is_3d_(id) || count_3d == 0 || found[id] != NULL,
+                "table file missing '%s': %s", lut_names_[id], path);
+    }
+
+    #undef LUT_CHECK_
+
+    for (i32 id=0; id<LUT_COUNT; ++id)
+        lut_tables_[id] = found[id];
+    lut_base_ = base;
+}
+
+const lutTable* lut_get(lutId id) {
+    assert(lut_base_ != NULL, "tables have not been loaded");
+    assert(lut_tables_[id] != NULL, "table not present: %s", lut_names_[id]);
+    return lut_tables_[id];
+}
+
+i32 lut_has(lutId id) {
+    assert(lut_base_ != NULL, "tables have not been loaded");
+    return lut_tables_[id] != NULL;
+}
+
+const f32* lut_data(const lutTable* lut) {
+    return (const void*)(lut_base_ + lut->offset);
+}
+
+
+f64 lut_bilinear(const f32* tbl, i32 xlen, i32 ylen, f64 t, f64 s) {
+    t *= xlen - 1;
+    s *= ylen - 1;
+    i32 i = min(max((i32)t, 0), xlen - 2);
+    i32 j = min(max((i32)s, 0), ylen - 2);
+    t -= i;
+    s -= j;
+    f64 v00 = tbl[ylen*i + j];
+    f64 v01 = tbl[ylen*i + j + 1];
+    f64 v10 = tbl[ylen*(i + 1) + j];
+    f64 v11 = tbl[ylen*(i + 1) + j + 1];
+    f64 v0 = v00 + s*(v01 - v00);
+    f64 v1 = v10 + s*(v11 - v10);
+    return v0 + t*(v1 - v0);
+}
+
+i64 lut_bilinear_many(const lutTable* lut, i64 N, const f64* rstr x,
+        f64 xscale, const f64* rstr y, f64 yscale, f64* rstr out,
+        u8* rstr oob) {
+    #define LANES (4)
+    const f32* tbl = lut_data(lut);
+    i32 xlen = (i32)lut->xlen;
+    i32 ylen = (i32)lut->ylen;
+    f64 xmul = (xlen - 1) / (lut->xhi - lut->xlo);
+    f64 ymul = (ylen - 1) / (lut->yhi - lut->ylo);
+    i64 count = 0;
+    for (i64 start=0; start<N; start+=LANES) {
+        i32 n = (i32)min(N - start, LANES);
+        f64 t[LANES] = {0};
+        f64 s[LANES] = {0};
+        i32 bad[LANES] = {0};
+        for (i32 l=0; l<n; ++l) {
+            f64 xl = x[start + l]*xscale;
+            f64 yl = y[start + l]*yscale;
+            // Written so nan inputs are also out of bounds.
+            bad[l] = !(lut->xlo <= xl && xl <= lut->xhi)
+                   | !(lut->ylo <= yl && yl <= lut->yhi);
+            t[l] = bad[l] ? 0.0 : (xl - lut->xlo)*xmul;
+            s[l] = bad[l] ? 0.0 : (yl - lut->ylo)*ymul;
+        }
+        i32 idx[LANES];
+        for (i32 l=0; l<LANES; ++l) {
+            i32 i = min((i32)t[l], xlen - 2);
+            i32 j = min((i32)s[l], ylen - 2);
+            t[l] -= i;
+            s[l] -= j;
+            idx[l] = ylen*i + j;
+        }
+        f64 v00[LANES];
+        f64 v01[LANES];
+        f64 v10[LANES];
+        f64 v11[LANES];
+        for (i32 l=0; l<LANES; ++l) {
+            v00[l] = tbl[idx[l]];
+            v01[l] = tbl[idx[l] + 1];
+            v10[l] = tbl[idx[l] + ylen];
+            v11[l] = tbl[idx[l] + ylen + 1];
+        }
+        f64 v[LANES];
+        for (i32 l=0; l<LANES; ++l) {
+            f64 v0 = v00[l] + s[l]*(v01[l] - v00[l]);
+            f64 v1 = v10[l] + s[l]*(v11[l] - v10[l]);
+            v[l] = v0 + t[l]*(v1 - v0);
+        }
+        for (i32 l=0; l<n; ++l) {
+            bad[l] |= isnan(v[l]);
+            count += bad[l];
+            out[start + l] = bad[l] ? NAN : v[l];
+            if (oob != NULL)
+                oob[start + l] = (u8)bad[l];
+        }
+    }
+    return count;
+    #undef LANES
+}
+
+
+f64 lut_trilinear(const f32* tbl, i32 xlen, i32 ylen, i32 zlen, f64 t, f64 s,
+        f64 r) {
+    t *= xlen - 1;
+    s *= ylen - 1;
+    r *= zlen - 1;
+    i32 i = min(max((i32)t, 0), xlen - 2);
+    i32 j = min(max((i32)s, 0), ylen - 2);
+    i32 k = min(max((i32)r, 0), zlen - 2);
+    t -= i;
+    s -= j;
+    r -= k;
+    // Corners ordered 00, 01, 10, 11 over (x, y), each pair is adjacent in z.
+    i64 base[4] = {
+        (ylen*(i64)i + j)*zlen + k,
+        (ylen*(i64)i + j + 1)*zlen + k,
+        (ylen*(i64)(i + 1) + j)*zlen + k,
+        (ylen*(i64)(i + 1) + j + 1)*zlen + k,
+    };
+    f64 lo[4];
+    f64 hi[4];
+    for (i32 c=0; c<4; ++c) {
+        lo[c] = tbl[base[c]];
+        hi[c] = tbl[base[c] + 1];
+    }
+    f64 v[4];
+    for (i32 c=0; c<4; ++c)
+        v[c] = lo[c] + r*(hi[c] - lo[c]);
+    f64 v0 = v[0] + s*(v[1] - v[0]);
+    f64 v1 = v[2] + s*(v[3] - v[2]);
+    return v0 + t*(v1 - v0);
+}
+
+i64 lut_trilinear_many(const lutTable* lut, i64 N, const f64* rstr x,
+        f64 xscale, const f64* rstr y, f64 yscale, const f64* rstr z,
+        f64 zscale, f64* rstr out, u8* rstr oob) {
+    #define LANES (4)
+    const f32* tbl = lut_data(lut);
+    i32 xlen = (i32)lut->xlen;
+    i32 ylen = (i32)lut->ylen;
+    i32 zlen = (i32)lut->zlen;
+    f64 xmul = (xlen - 1) / (lut->xhi - lut->xlo);
+    f64 ymul = (ylen - 1) / (lut->yhi - lut->ylo);
+    f64 zmul = (zlen - 1) / (lut->zhi - lut->zlo);
+    i64 count = 0;
+    for (i64 start=0; start<N; start+=LANES) {
+        i32 n = (i32)min(N - start, LANES);
+        f64 t[LANES] = {0};
+        f64 s[LANES] = {0};
+        f64 r[LANES] = {0};
+        i32 bad[LANES] = {0};
+        for (i32 l=0; l<n; ++l) {
+            f64 xl = x[start + l]*xscale;
+            f64 yl = y[start + l]*yscale;
+            f64 zl = z[start + l]*zscale;
+            // Written so nan inputs are also out of bounds.
+            bad[l] = !(lut->xlo <= xl && xl <= lut->xhi)
+                   | !(lut->ylo <= yl && yl <= lut->yhi)
+                   | !(lut->zlo <= zl && zl <= lut->zhi);
+            t[l] = bad[l] ? 0.0 : (xl - lut->xlo)*xmul;
+            s[l] = bad[l] ? 0.0 : (yl - lut->ylo)*ymul;
+            r[l] = bad[l] ? 0.0 : (zl - lut->zlo)*zmul;
+        }
+        // Corners ordered 00, 01, 10, 11 over (x, y), each pair adjacent in z.
+        i64 idx[LANES];
+        for (i32 l=0; l<LANES; ++l) {
+            i32 i = min((i32)t[l], xlen - 2);
+            i32 j = min((i32)s[l], ylen - 2);
+            i32 k = min((i32)r[l], zlen - 2);
+            t[l] -= i;
+            s[l] -= j;
+            r[l] -= k;
+            idx[l] = (ylen*(i64)i + j)*zlen + k;
+        }
+        i64 stride[4] = { 0, zlen, ylen*(i64)zlen, (ylen + 1)*(i64)zlen };
+        f64 v[4][LANES];
+        for (i32 c=0; c<4; ++c) {
+            f64 lo[LANES];
+            f64 hi[LANES];
+            for (i32 l=0; l<LANES; ++l) {
+                lo[l] = tbl[idx[l] + stride[c]];
+                hi[l] = tbl[idx[l] + stride[c] + 1];
+            }
+            for (i32 l=0; l<LANES; ++l)
+                v[c][l] = lo[l] + r[l]*(hi[l] - lo[l]);
+        }
+        f64 w[LANES];
+        for (i32 l=0; l<LANES; ++l) {
+            f64 v0 = v[0][l] + s[l]*(v[1][l] - v[0][l]);
+            f64 v1 = v[2][l] + s[l]*(v[3][l] - v[2][l]);
+            w[l] = v0 + t[l]*(v1 - v0);
+        }
+        for (i32 l=0; l<n; ++l) {
+            bad[l] |= isnan(w[l]);
+            count += bad[l];
+            out[start + l] = bad[l] ? NAN : w[l];
+            if (oob != NULL)
+                oob[start + l] = (u8)bad[l];
+        }
+    }
+    return count;
+    #undef LANES
+}
+
+
+static f64 catmullrom_(f64 p0, f64 p1, f64 p2, f64 p3, f64 t) {
+    f64 a = p2 - p0;
+    f64 b = 2.0*p0 - 5.0*p1 + 4.0*p2 - p3;
+    f64 c = 3.0*(p1 - p2) + p3 - p0;
+    return p1 + 0.5*t*(a + t*(b + t*c));
+}
+
+static f64 catmullrom_row_(const f32* row, i32 ylen, i32 j, f64 s) {
+    f64 p1 = row[j];
+    f64 p2 = row[j + 1];
+    // Linearly extrapolate past the edges.
+    f64 p0 = (j > 0) ? row[j - 1] : 2.0*p1 - p2;
+    f64 p3 = (j + 2 < ylen) ? row[j + 2] : 2.0*p2 - p1;
+    return catmullrom_(p0, p1, p2, p3, s);
+}
+
+f64 lut_catmullrom(const f32* tbl, i32 xlen, i32 ylen, f64 t, f64 s) {
+    f64 ti = t * (xlen - 1);
+    f64 sj = s * (ylen - 1);
+    i32 i = min(max((i32)ti, 0), xlen - 2);
+    i32 j = min(max((i32)sj, 0), ylen - 2);
+    ti -= i;
+    sj -= j;
+    f64 q1 = catmullrom_row_(tbl + ylen*i, ylen, j, sj);
+    f64 q2 = catmullrom_row_(tbl + ylen*(i + 1), ylen, j, sj);
+    f64 q0 = (i > 0) ? catmullrom_row_(tbl + ylen*(i - 1), ylen, j, sj)
+                     : 2.0*q1 - q2;
+    f64 q3 = (i + 2 < xlen) ? catmullrom_row_(tbl + ylen*(i + 2), ylen, j, sj)
+                            : 2.0*q2 - q1;
+    f64 v = catmullrom_(q0, q1, q2, q3, ti);
+    // Dont let the wider stencil shrink the valid domain near masked entries.
+    if (unlikely(isnan(v)))
+        return lut_bilinear(tbl, xlen, ylen, t, s);
+    return v;
+}
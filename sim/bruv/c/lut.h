@@ -0,0 +1,152 @@
+#pragma once
+#include "br.h"
+
+
+// Every table the approximations require, by name (matching its source file in
+// ../tbl/).
+#define LUT_TABLES                                              \
+    X(cea_Isp)                                                  \
+    X(cea_T_cc)                                                 \
+    X(cea_rho_cc)                                               \
+    X(cea_Mw_tht)                                               \
+    X(cea_gamma_cc)                                             \
+    X(cea_gamma_tht)                                            \
+    X(cea_gamma_lowm)                                           \
+    X(cea_gamma_midm)                                           \
+    X(cea_gamma_exit)                                           \
+    X(cea_cp_cc)                                                \
+    X(cea_cp_tht)                                               \
+    X(cea_cp_lowm)                                              \
+    X(cea_cp_midm)                                              \
+    X(cea_cp_exit)                                              \
+    X(cea_mu_cc)                                                \
+    X(cea_mu_tht)                                               \
+    X(cea_mu_lowm)                                              \
+    X(cea_mu_midm)                                              \
+    X(cea_mu_exit)                                              \
+    X(cea_Pr_cc)                                                \
+    X(cea_Pr_tht)                                               \
+    X(cea_Pr_lowm)                                              \
+    X(cea_Pr_midm)                                              \
+    X(cea_Pr_exit)                                              \
+    X(ipa_rho)                                                  \
+    X(ipa_cp)                                                   \
+    X(ipa_mu)                                                   \
+    X(ipa_k)                                                    \
+    X(ethanol_rho)                                              \
+    X(ethanol_cp)                                               \
+    X(ethanol_mu)                                               \
+    X(ethanol_k)                                                \
+
+// Tables which are additionally functions of the nozzle expansion ratio, which
+// lift the ideal sea-level expansion assumed by the above. These are optional,
+// the approximations fall back to the sea-level tables when the file has none.
+#define LUT_TABLES_3D                                           \
+    X(cea3_Isp)                                                 \
+    X(cea3_gamma_lowm)                                          \
+    X(cea3_gamma_midm)                                          \
+    X(cea3_gamma_exit)                                          \
+    X(cea3_cp_lowm)                                             \
+    X(cea3_cp_midm)                                             \
+    X(cea3_cp_exit)                                             \
+    X(cea3_mu_lowm)                                             \
+    X(cea3_mu_midm)                                             \
+    X(cea3_mu_exit)                                             \
+    X(cea3_Pr_lowm)                                             \
+    X(cea3_Pr_midm)                                             \
+    X(cea3_Pr_exit)                                             \
+
+typedef enum lutId {
+    #define X(name) LUT_##name,
+    LUT_TABLES
+    LUT_TABLES_3D
+    #undef X
+    LUT_COUNT
+} lutId;
+
+
+// The tables are not compiled in, instead they are packed into a single binary
+// file (by `bruv.build`) which is memory-mapped on load. Its layout is:
+//   lutFileHeader
+//   lutTable[count]
+//   table data (each at its `offset`, 64-byte aligned)
+// All native-endian. 2D tables have `zlen` of 1 (and zero z bounds).
+
+#define LUT_MAGIC (0x0054554C56555242ULL) // "BRUVLUT\0"
+#define LUT_VERSION (2)
+
+typedef struct lutFileHeader {
+    u64 magic;
+    i64 version;
+    i64 count; // number of tables.
+    i64 size; // [bytes] of the entire file.
+} lutFileHeader;
+
+typedef struct lutTable {
+    char name[32]; // null-terminated.
+    f64 xlo;
+    f64 xhi;
+    f64 ylo;
+    f64 yhi;
+    f64 zlo;
+    f64 zhi;
+    f64 abserr; // max fit error, relative to the value.
+    f64 relerr; // max fit error, relative to the range.
+    i64 xlen;
+    i64 ylen;
+    i64 zlen;
+    i64 offset; // [bytes] from the start of the file to the f32 data.
+} lutTable;
+
+// Maps the table file at `path`. Errors are handled via asserts.
+void lut_load(const char* path);
+
+// Returns the given table, asserting the tables have been loaded (and that it
+// is present, for optional tables).
+const lutTable* lut_get(lutId id);
+
+// Returns non-zero if the given table is present, asserting the tables have
+// been loaded.
+i32 lut_has(lutId id);
+
+// Returns the evenly-spaced flattened (C-ordered) 2D or 3D data of the given
+// table.
+const f32* lut_data(const lutTable* lut);
+
+
+// Interpolation kernels for the tables. `t` and `s` are the normalised
+// coordinates along x and y (0 at the first row/column, 1 at the last). Note
+// masked table entries are nan, and so is any result which depends on them.
+// Tables are stored as f32 (their fit error dwarfs the rounding, which the
+// approximator reports) but always interpolated in f64.
+
+// Standard bilinear interpolation between the four surrounding entries.
+f64 lut_bilinear(const f32* tbl, i32 xlen, i32 ylen, f64 t, f64 s);
+
+// Batch bilinear interpolation of `lut` at the `N` points (`x[i]*xscale`,
+// `y[i]*yscale`). Rather than asserting, any point outside the table bounds (or
+// touching a masked entry) gives nan and is flagged in `oob` (if non-null).
+// Returns the number of such points. Points are processed in groups of four,
+// with each corner gathered into its own lane array before blending.
+i64 lut_bilinear_many(const lutTable* lut, i64 N, const f64* rstr x,
+        f64 xscale, const f64* rstr y, f64 yscale, f64* rstr out,
+        u8* rstr oob);
+
+// Bicubic (catmull-rom) interpolation over the sixteen surrounding entries, which
+// allows far coarser tables for the same error. The table edges are extended by
+// linear extrapolation, and any cell whose stencil touches a masked entry falls
+// back to bilinear (so the valid domain is identical to `lut_bilinear`).
+f64 lut_catmullrom(const f32* tbl, i32 xlen, i32 ylen, f64 t, f64 s);
+
+// Trilinear interpolation between the eight surrounding entries, with `r` the
+// normalised coordinate along z. Each corner pair is gathered contiguously so
+// the blend is done as fixed-width vectors.
+f64 lut_trilinear(const f32* tbl, i32 xlen, i32 ylen, i32 zlen, f64 t, f64 s,
+        f64 r);
+
+// Batch trilinear interpolation of `lut` at the `N` points (`x[i]*xscale`,
+// `y[i]*yscale`, `z[i]*zscale`), with out-of-bounds points handled as in
+// `lut_bilinear_many`.
+i64 lut_trilinear_many(const lutTable* lut, i64 N, const f64* rstr x,
+        f64 xscale, const f64* rstr y, f64 yscale, const f64* rstr z,
+        f64 zscale, f64* rstr out, u8* rstr oob);
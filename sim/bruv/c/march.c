@@ -0,0 +1,106 @@
+#if defined(MARCH) && MARCH
+
+#include "br.h"
+
+#include "assertion.h"
+#include "lut.h"
+#include "maths.h"
+#include "sim.h"
+
+
+// Checks the parallel coolant march against the serial one, over every coolant,
+// friction factor and stress mode of a typical engine. Fails if any output the
+// march feeds differs by more than `MARCH_MAX_ERROR` (relatively).
+
+
+// Both converge to within the wall tolerance of the same solution, from
+// different starting points.
+#define MARCH_MAX_ERROR (1e-5)
+
+// Threads of the parallel march.
+#define MARCH_THREADS (4)
+
+
+static void march_setup(simState* s, i64 coolant, i64 friction, i64 fused,
+        i64 threads) {
+    *s = (simState){0};
+    s->Lstar = 0.8;
+    s->R_cc = 45e-3;
+    s->NLF = 1.0;
+    s->phi_conv = -PI/6.0;
+    s->prop_fc = 0.15;
+    s->helix_angle = PI/6.0;
+    s->th_pdms = 30e-6;
+    s->k_pdms = 1.3;
+    s->th_iw = 1.1e-3;
+    s->th_ow = 3.5e-3;
+    s->no_chnl = 40;
+    s->th_chnl = 1.5e-3;
+    s->prop_chnl = 0.6;
+    s->eps_chnl = 135e-6;
+    s->friction = friction;
+    s->Pr_fu = 1.2;
+    s->T_fu0 = 298.15;
+    s->coolant = coolant;
+    s->thermal_threads = threads;
+    s->fused_stress = fused;
+    s->ofr = 1.4;
+    s->dm_cc = 2.15;
+    s->P_exit = 101325.0;
+    s->P0_cc = 3.5e6;
+    s->target_Thrust = 5000.0;
+}
+
+// Relative difference of `a` from `b`.
+static f64 march_error(f64 a, f64 b) {
+    return abs(a - b) / max(abs(b), 1e-300);
+}
+
+static void march_check(i64 coolant, i64 friction, i64 fused) {
+    simState* serial = &(simState){0};
+    simState* parallel = &(simState){0};
+    march_setup(serial, coolant, friction, fused, 1);
+    march_setup(parallel, coolant, friction, fused, MARCH_THREADS);
+    sim_execute(serial);
+    sim_execute(parallel);
+
+    assert(parallel->possible_system == serial->possible_system,
+            "possible_system differs (%lld vs %lld serially)",
+            parallel->possible_system, serial->possible_system);
+    f64 worst = 0.0;
+    #define MARCH_COMPARE(name) do {                                        \
+            f64 err = march_error(parallel->name, serial->name);            \
+            worst = max(worst, err);                                        \
+            assert(err <= MARCH_MAX_ERROR, #name " is %.3g off serial (%.12g "\
+                    "vs %.12g)", err, parallel->name, serial->name);        \
+        } while (0)
+    MARCH_COMPARE(P_fu0);
+    MARCH_COMPARE(T_fu1);
+    MARCH_COMPARE(P_fu1);
+    MARCH_COMPARE(min_SF);
+    #undef MARCH_COMPARE
+    printf("coolant %lld, friction %lld, fused %lld: max error %.3g\n",
+            coolant, friction, fused, worst);
+}
+
+
+i32 main(i32 argc, char** argv);
+i32 main(i32 argc, char** argv) {
+    if (assertion_has_failed()) {
+        printf("%s\n", assertion_message());
+        return 1;
+    }
+
+    assert(argc == 2, "usage: %s <tables>", argv[0]);
+    lut_load(argv[1]);
+    for (i64 coolant=0; coolant<COOLANT_COUNT; ++coolant) {
+        for (i64 friction=0; friction<FRICTION_COUNT; ++friction) {
+            for (i64 fused=0; fused<2; ++fused)
+                march_check(coolant, friction, fused);
+        }
+    }
+    printf("all within %g.\n", MARCH_MAX_ERROR);
+    return 0;
+}
+
+#endif
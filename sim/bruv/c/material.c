@@ -1,24 +1,22 @@
 #include "material.h"
 
+#include "maths.h"
+
 
 f64 CuCr1Zr_Ys(f64 T) {
-    f64 Ys = (-2.2847e2*T - 1.3931e5)*T + 2.268e8;
-    return max(1e6, Ys);
+    return CuCr1Zr_Ys_dvec4(dvec4(T))[0];
 }
 
 f64 CuCr1Zr_Us(f64 T) {
-    f64 Us = -4.2631e5*T + 3.4104e8;
-    return max(1e6, Us);
+    return CuCr1Zr_Us_dvec4(dvec4(T))[0];
 }
 
 f64 CuCr1Zr_E(f64 T) {
-    f64 E = (-1.9234e5*T - 2.1233e7)*T + 1.2491e11;
-    return max(1e9, E);
+    return CuCr1Zr_E_dvec4(dvec4(T))[0];
 }
 
 f64 CuCr1Zr_pois(f64 T) {
-    (void)T;
-    return 0.38;
+    return CuCr1Zr_pois_dvec4(dvec4(T))[0];
 }
 
 f64 CuCr1Zr_k(void) {
@@ -26,6 +24,31 @@ f64 CuCr1Zr_k(void) {
 }
 
 f64 CuCr1Zr_alpha(f64 T) {
+    return CuCr1Zr_alpha_dvec4(dvec4(T))[0];
+}
+
+
+dvec4 CuCr1Zr_Ys_dvec4(dvec4 T) {
+    dvec4 Ys = (-2.2847e2*T - 1.3931e5)*T + 2.268e8;
+    return max(dvec4(1e6), Ys);
+}
+
+dvec4 CuCr1Zr_Us_dvec4(dvec4 T) {
+    dvec4 Us = -4.2631e5*T + 3.4104e8;
+    return max(dvec4(1e6), Us);
+}
+
+dvec4 CuCr1Zr_E_dvec4(dvec4 T) {
+    dvec4 E = (-1.9234e5*T - 2.1233e7)*T + 1.2491e11;
+    return max(dvec4(1e9), E);
+}
+
+dvec4 CuCr1Zr_pois_dvec4(dvec4 T) {
+    (void)T;
+    return dvec4(0.38);
+}
+
+dvec4 CuCr1Zr_alpha_dvec4(dvec4 T) {
     (void)T;
-    return 1.635e-5;
+    return dvec4(1.635e-5);
 }
@@ -8,3 +8,10 @@ f64 CuCr1Zr_E(f64 T);
 f64 CuCr1Zr_pois(f64 T);
 f64 CuCr1Zr_k(void);
 f64 CuCr1Zr_alpha(f64 T);
+
+// Four temperatures at once, each lane identical to the above.
+dvec4 CuCr1Zr_Ys_dvec4(dvec4 T);
+dvec4 CuCr1Zr_Us_dvec4(dvec4 T);
+dvec4 CuCr1Zr_E_dvec4(dvec4 T);
+dvec4 CuCr1Zr_pois_dvec4(dvec4 T);
+dvec4 CuCr1Zr_alpha_dvec4(dvec4 T);
@@ -314,6 +314,16 @@ vec4 min_vec4(vec4 a, vec4 b) {
     i32x4 ret = (fp_bits(a) & comp) | (fp_bits(b) & ~comp);
     return fp_from_bits(ret);
 }
+dvec2 min_dvec2(dvec2 a, dvec2 b) {
+    i64x2 comp = (a < b) | (b != b);
+    i64x2 ret = (fp_bits(a) & comp) | (fp_bits(b) & ~comp);
+    return fp_from_bits(ret);
+}
+dvec4 min_dvec4(dvec4 a, dvec4 b) {
+    i64x4 comp = (a < b) | (b != b);
+    i64x4 ret = (fp_bits(a) & comp) | (fp_bits(b) & ~comp);
+    return fp_from_bits(ret);
+}
 
 i32 max_i32(i32 a, i32 b) { return (a > b) ? a : b; }
 i64 max_i64(i64 a, i64 b) { return (a > b) ? a : b; }
@@ -334,6 +344,16 @@ vec4 max_vec4(vec4 a, vec4 b) {
     i32x4 ret = (fp_bits(a) & comp) | (fp_bits(b) & ~comp);
     return fp_from_bits(ret);
 }
+dvec2 max_dvec2(dvec2 a, dvec2 b) {
+    i64x2 comp = (a > b) | (b != b);
+    i64x2 ret = (fp_bits(a) & comp) | (fp_bits(b) & ~comp);
+    return fp_from_bits(ret);
+}
+dvec4 max_dvec4(dvec4 a, dvec4 b) {
+    i64x4 comp = (a > b) | (b != b);
+    i64x4 ret = (fp_bits(a) & comp) | (fp_bits(b) & ~comp);
+    return fp_from_bits(ret);
+}
 
 
 i32 minelem_i32(i32 x) { return x; }
@@ -436,6 +456,34 @@ f32 f32_split(f32 pos_norm_f, i32* exp) {
     return fp_from_bits(bits);
 }
 
+// Lane-wise `cond ? a : b`, where `cond` is the result of a vector comparison
+// (so each lane is all ones or all zeros).
+static dvec4 dvec4_blend_(i64x4 cond, dvec4 a, dvec4 b) {
+    return fp_from_bits((fp_bits(a) & cond) | (fp_bits(b) & ~cond));
+}
+// Lane-wise `f64_with_exp`.
+static dvec4 dvec4_with_exp_(i32x4 exp) {
+    i64x4 e = __builtin_convertvector(exp, i64x4);
+    return fp_from_bits((e + fp_exp_bias(f64)) << fp_mant_len(f64));
+}
+// Lane-wise `f64_split`. Lanes which aren't positive normals give garbage, but
+// still a finite exponent.
+static dvec4 dvec4_split_(dvec4 pos_norm_f, i32x4* exp) {
+    i64x4 bits = fp_bits(pos_norm_f);
+
+    // The exponent lives entirely in the high half of each lane, so pack those
+    // down and do the rest in i32 (which also converts to f64 in one go, unlike
+    // i64 pre-avx512).
+    typedef Vector(i32, 8) i32x8;
+    i32x8 halves = (i32x8)bits;
+    i32x4 hi = __builtin_shufflevector(halves, halves, 1, 3, 5, 7);
+    *exp = ((hi >> (fp_mant_len(f64) - 32)) & 0x7FF) - fp_exp_bias(f64);
+
+    bits &= (i64)~fp_exp_mask(f64);
+    bits |= (i64)fp_exp_bias(f64) << fp_mant_len(f64);
+    return fp_from_bits(bits);
+}
+
 i32 signbit_f32(f32 f) { return __builtin_signbitf(f); }
 i32 signbit_f64(f64 f) { return __builtin_signbit(f); }
 
@@ -627,6 +675,16 @@ vec4 sqrt_vec4(vec4 x) {
                , __builtin_sqrtf(x[2])
                , __builtin_sqrtf(x[3]) );
 }
+dvec2 sqrt_dvec2(dvec2 x) {
+    return dvec2( __builtin_sqrt(x[0])
+                , __builtin_sqrt(x[1]) );
+}
+dvec4 sqrt_dvec4(dvec4 x) {
+    return dvec4( __builtin_sqrt(x[0])
+                , __builtin_sqrt(x[1])
+                , __builtin_sqrt(x[2])
+                , __builtin_sqrt(x[3]) );
+}
 
 
 f64 cbrt_f64(f64 x) {
@@ -738,6 +796,52 @@ vec4 cbrt_vec4(vec4 x) {
                , cbrt_f32(x[2])
                , cbrt_f32(x[3]) );
 }
+dvec2 cbrt_dvec2(dvec2 x) {
+    dvec4 r = cbrt_dvec4(dvec4(x[0], x[1], x[0], x[1]));
+    return dvec2(r[0], r[1]);
+}
+dvec4 cbrt_dvec4(dvec4 x) {
+    // Same as `cbrt_f64`, except every lane takes the main path (on `|x|`) and
+    // the edge cases are blended in after.
+    i64x4 sign = fp_bits(x) & (i64)fp_sign_mask(f64);
+    dvec4 a = fp_from_bits(fp_bits(x) & ~sign);
+
+    i32x4 e;
+    dvec4 m = dvec4_split_(a, &e);
+
+    f64 n0 = 0.1489960767650;
+    f64 n1 = 1.5893022238500;
+    f64 n2 = 1.5670873713800;
+    f64 n3 = 0.1821935521380;
+    f64 d0 = 0.4659660634460;
+    f64 d1 = 1.9817634131800;
+    f64 d2 = 0.9937808263990;
+    f64 d3 = 0.0460689162968;
+    dvec4 r = (
+        (((n3 * m + n2) * m + n1) * m + n0)
+        /
+        (((d3 * m + d2) * m + d1) * m + d0)
+    );
+
+    i32x4 k = (e / 3);
+    i32x4 j = (e % 3);
+
+    // Multiplying by one is exact, so we can blend in the `2^(j/3)` instead of
+    // switching on it.
+    r *= dvec4_with_exp_(k);
+    dvec4 jf = __builtin_convertvector(j, dvec4);
+    dvec4 rootj = dv4ONE;
+    rootj = dvec4_blend_((i64x4)(jf == -2.0), dvec4(0.629960524947), rootj);
+    rootj = dvec4_blend_((i64x4)(jf == -1.0), dvec4(0.793700525984), rootj);
+    rootj = dvec4_blend_((i64x4)(jf ==  1.0), dvec4(1.259921049890), rootj);
+    rootj = dvec4_blend_((i64x4)(jf ==  2.0), dvec4(1.587401051970), rootj);
+    r *= rootj;
+
+    r = dvec4_blend_((i64x4)(a < fp_norm_min(f64)), dv4ZERO, r);
+    r = fp_from_bits(fp_bits(r) | sign);
+    r = dvec4_blend_((i64x4)(x != x) | (i64x4)(a == INF), x, r);
+    return r;
+}
 
 
 f64 sqed_f64(f64 x) { return x*x; }
@@ -745,6 +849,8 @@ f32 sqed_f32(f32 x) { return x*x; }
 vec2 sqed_vec2(vec2 x) { return x*x; }
 vec3 sqed_vec3(vec3 x) { return x*x; }
 vec4 sqed_vec4(vec4 x) { return x*x; }
+dvec2 sqed_dvec2(dvec2 x) { return x*x; }
+dvec4 sqed_dvec4(dvec4 x) { return x*x; }
 
 
 f64 cbed_f64(f64 x) { return x*x*x; }
@@ -752,6 +858,8 @@ f32 cbed_f32(f32 x) { return x*x*x; }
 vec2 cbed_vec2(vec2 x) { return x*x*x; }
 vec3 cbed_vec3(vec3 x) { return x*x*x; }
 vec4 cbed_vec4(vec4 x) { return x*x*x; }
+dvec2 cbed_dvec2(dvec2 x) { return x*x*x; }
+dvec4 cbed_dvec4(dvec4 x) { return x*x*x; }
 
 
 f64 exp2_f64(f64 x) {
@@ -855,6 +963,49 @@ vec4 exp2_vec4(vec4 x) {
                , exp2_f32(x[2])
                , exp2_f32(x[3]) );
 }
+dvec2 exp2_dvec2(dvec2 x) {
+    dvec4 r = exp2_dvec4(dvec4(x[0], x[1], x[0], x[1]));
+    return dvec2(r[0], r[1]);
+}
+dvec4 exp2_dvec4(dvec4 x) {
+    // Same as `exp2_f64`, except every lane takes the main path and the edge
+    // cases are blended in after. Lanes headed for an edge case are zeroed first
+    // so their exponent is still sane.
+    i64x4 hi = (i64x4)(x >= 1024.0);
+    i64x4 lo = (i64x4)(x <= -1022.0);
+    i64x4 nan = (i64x4)(x != x);
+    x = dvec4_blend_(hi | lo | nan, dv4ZERO, x);
+
+    // Split via floor directly (no vector truncating-conversion needed), which
+    // gives the exact same `f` in 0..1 as the scalar truncate-then-take.
+    dvec4 i = dvec4( __builtin_floor(x[0])
+                   , __builtin_floor(x[1])
+                   , __builtin_floor(x[2])
+                   , __builtin_floor(x[3]) );
+    dvec4 f = x - i;
+
+    f64 n0 = +3.67657762666000;
+    f64 n1 = +1.31942423003000;
+    f64 n2 = +0.19282487450200;
+    f64 n3 = +0.01220740233640;
+    f64 d0 = +3.67657762721000;
+    f64 d1 = -1.22898523359000;
+    f64 d2 = +0.16148178495000;
+    f64 d3 = -0.00855711197218;
+    dvec4 exp2f = (
+        (((n3 * f + n2) * f + n1) * f + n0)
+        /
+        (((d3 * f + d2) * f + d1) * f + d0)
+    );
+
+    dvec4 exp2i = dvec4_with_exp_(__builtin_convertvector(i, i32x4));
+
+    dvec4 r = exp2i * exp2f;
+    r = dvec4_blend_(hi, dv4INF, r);
+    r = dvec4_blend_(lo, dv4ZERO, r);
+    r = dvec4_blend_(nan, dv4NAN, r);
+    return r;
+}
 
 
 f64 log2_f64(f64 x) {
@@ -952,6 +1103,37 @@ vec4 log2_vec4(vec4 x) {
                , log2_f32(x[2])
                , log2_f32(x[3]) );
 }
+dvec2 log2_dvec2(dvec2 x) {
+    dvec4 r = log2_dvec4(dvec4(x[0], x[1], x[0], x[1]));
+    return dvec2(r[0], r[1]);
+}
+dvec4 log2_dvec4(dvec4 x) {
+    // Same as `log2_f64`, except every lane takes the main path and the edge
+    // cases are blended in after (in reverse order of precedence).
+    i32x4 e;
+    dvec4 m = dvec4_split_(x, &e);
+
+    f64 n0 = -4.958898909080;
+    f64 n1 = -6.612108365090;
+    f64 n2 = +9.333280025010;
+    f64 n3 = +2.237727255500;
+    f64 d0 = +1.023735966000;
+    f64 d1 = +6.730341730150;
+    f64 d2 = +4.867463372800;
+    f64 d3 = +0.387193700112;
+    dvec4 log2m = (
+        (((n3 * m + n2) * m + n1) * m + n0)
+        /
+        (((d3 * m + d2) * m + d1) * m + d0)
+    );
+
+    dvec4 r = log2m + __builtin_convertvector(e, dvec4);
+    r = dvec4_blend_((i64x4)(x == 1.0), dv4ZERO, r);
+    r = dvec4_blend_((i64x4)(x == INF), dv4INF, r);
+    r = dvec4_blend_((i64x4)(x < fp_norm_min(f64)), -dv4INF, r);
+    r = dvec4_blend_((i64x4)(x != x) | (i64x4)(x < 0.0), dv4NAN, r);
+    return r;
+}
 
 
 f64 pow_f64(f64 x, f64 n) { return exp2(log2(x) * n); }
@@ -959,6 +1141,8 @@ f32 pow_f32(f32 x, f32 n) { return exp2(log2(x) * n); }
 vec2 pow_vec2(vec2 x, vec2 n) { return exp2(log2(x) * n); }
 vec3 pow_vec3(vec3 x, vec3 n) { return exp2(log2(x) * n); }
 vec4 pow_vec4(vec4 x, vec4 n) { return exp2(log2(x) * n); }
+dvec2 pow_dvec2(dvec2 x, dvec2 n) { return exp2(log2(x) * n); }
+dvec4 pow_dvec4(dvec4 x, dvec4 n) { return exp2(log2(x) * n); }
 
 
 f64 sin_f64(f64 x) {
@@ -400,7 +400,8 @@ vec4 iabs_vec4(vec4 x);
 
 // Returns the minimum of the given numbers (or the only non-nan).
 // - Element-wise for vector types.
-#define min(a, b) ( choose_all_2_(min, (a), (b)) )
+// - Accepts `dvec2`/`dvec4`.
+#define min(a, b) ( choose_alld_2_(min, (a), (b)) )
 i32 min_i32(i32 a, i32 b);
 i64 min_i64(i64 a, i64 b);
 u32 min_u32(u32 a, u32 b);
@@ -410,10 +411,13 @@ f64 min_f64(f64 a, f64 b);
 vec2 min_vec2(vec2 a, vec2 b);
 vec3 min_vec3(vec3 a, vec3 b);
 vec4 min_vec4(vec4 a, vec4 b);
+dvec2 min_dvec2(dvec2 a, dvec2 b);
+dvec4 min_dvec4(dvec4 a, dvec4 b);
 
 // Returns the maximum of the given numbers (or the only non-nan).
 // - Element-wise for vector types.
-#define max(a, b) ( choose_all_2_(max, (a), (b)) )
+// - Accepts `dvec2`/`dvec4`.
+#define max(a, b) ( choose_alld_2_(max, (a), (b)) )
 i32 max_i32(i32 a, i32 b);
 i64 max_i64(i64 a, i64 b);
 u32 max_u32(u32 a, u32 b);
@@ -423,6 +427,8 @@ f64 max_f64(f64 a, f64 b);
 vec2 max_vec2(vec2 a, vec2 b);
 vec3 max_vec3(vec3 a, vec3 b);
 vec4 max_vec4(vec4 a, vec4 b);
+dvec2 max_dvec2(dvec2 a, dvec2 b);
+dvec4 max_dvec4(dvec4 a, dvec4 b);
 
 
 // Returns the minimum element (ignoring nans) in the given floating point
@@ -585,76 +591,102 @@ i64 iceil_f32(f32 x);
 u64 isqrt(u64 x);
 
 
+// Those below noted as accepting `dvec2`/`dvec4` evaluate every lane without
+// branching (special cases are blended in afterwards), so they compile to
+// straight SSE2/AVX. Each lane is bitwise identical to the `f64` version.
+
+
 // Returns the square root of `x`, `x^(1/2)`. Requires the compiler to be using
 // an instruction set that has a sqrt instrinsic bc i cant be bothered to impl it
 // myself.
 // - Element-wise for vector types.
-#define sqrt(x) ( choose_fp_1_(sqrt, (x)) )
+// - Accepts `dvec2`/`dvec4`.
+#define sqrt(x) ( choose_fpd_1_(sqrt, (x)) )
 f64 sqrt_f64(f64 x);
 f32 sqrt_f32(f32 x);
 vec2 sqrt_vec2(vec2 x);
 vec3 sqrt_vec3(vec3 x);
 vec4 sqrt_vec4(vec4 x);
+dvec2 sqrt_dvec2(dvec2 x);
+dvec4 sqrt_dvec4(dvec4 x);
 
 // Returns the cube root of `x`, `x^(1/3)`. Note this works for negative inputs,
 // while `pow` would not.
 // - Element-wise for vector types.
-#define cbrt(x) ( choose_fp_1_(cbrt, (x)) )
+// - Accepts `dvec2`/`dvec4`.
+#define cbrt(x) ( choose_fpd_1_(cbrt, (x)) )
 f64 cbrt_f64(f64 x);
 f32 cbrt_f32(f32 x);
 vec2 cbrt_vec2(vec2 x);
 vec3 cbrt_vec3(vec3 x);
 vec4 cbrt_vec4(vec4 x);
+dvec2 cbrt_dvec2(dvec2 x);
+dvec4 cbrt_dvec4(dvec4 x);
 
 // Returns `x` squared, `x^2`.
 // - Element-wise for vector types.
-#define sqed(x) ( choose_fp_1_(sqed, (x)) )
+// - Accepts `dvec2`/`dvec4`.
+#define sqed(x) ( choose_fpd_1_(sqed, (x)) )
 f64 sqed_f64(f64 x);
 f32 sqed_f32(f32 x);
 vec2 sqed_vec2(vec2 x);
 vec3 sqed_vec3(vec3 x);
 vec4 sqed_vec4(vec4 x);
+dvec2 sqed_dvec2(dvec2 x);
+dvec4 sqed_dvec4(dvec4 x);
 
 // Returns `x` cubed, `x^3`.
 // - Element-wise for vector types.
-#define cbed(x) ( choose_fp_1_(cbed, (x)) )
+// - Accepts `dvec2`/`dvec4`.
+#define cbed(x) ( choose_fpd_1_(cbed, (x)) )
 f64 cbed_f64(f64 x);
 f32 cbed_f32(f32 x);
 vec2 cbed_vec2(vec2 x);
 vec3 cbed_vec3(vec3 x);
 vec4 cbed_vec4(vec4 x);
+dvec2 cbed_dvec2(dvec2 x);
+dvec4 cbed_dvec4(dvec4 x);
 
 
 // Returns `2^x`, requiring `-1022 < x < 1024`. Not perfectly accurate, max error
 // of ~0.00000002%.
 // - Element-wise for vector types.
-#define exp2(x) ( choose_fp_1_(exp2, (x)) )
+// - Accepts `dvec2`/`dvec4`.
+#define exp2(x) ( choose_fpd_1_(exp2, (x)) )
 f64 exp2_f64(f64 x);
 f32 exp2_f32(f32 x);
 vec2 exp2_vec2(vec2 x);
 vec3 exp2_vec3(vec3 x);
 vec4 exp2_vec4(vec4 x);
+dvec2 exp2_dvec2(dvec2 x);
+dvec4 exp2_dvec4(dvec4 x);
 
 // Returns `log_2(x)`, requiring `x >= 2.2250738585072014e-308`. Not perfectly
 // accurate, max error of ~0.0000008%, however much higher as the output grows
 // very close to 0 (input closer to 1).
 // - Element-wise for vector types.
-#define log2(x) ( choose_fp_1_(log2, (x)) )
+// - Accepts `dvec2`/`dvec4`.
+#define log2(x) ( choose_fpd_1_(log2, (x)) )
 f64 log2_f64(f64 x);
 f32 log2_f32(f32 x);
 vec2 log2_vec2(vec2 x);
 vec3 log2_vec3(vec3 x);
 vec4 log2_vec4(vec4 x);
+dvec2 log2_dvec2(dvec2 x);
+dvec4 log2_dvec4(dvec4 x);
 
 // Returns `x^n`, requiring `x > 0`. Uses a combination of `exp2` and `log2`, so
 // not perfectly accurate.
 // - Element-wise for vector types.
-#define pow(x, n) ( choose_fp_2_(pow, (x), (n)) )
+// - Accepts `dvec2`/`dvec4`.
+#define pow(x, n) ( choose_fpd_2_(pow, (x), (n)) )
 f64 pow_f64(f64 x, f64 n);
 f32 pow_f32(f32 x, f32 n);
 vec2 pow_vec2(vec2 x, vec2 n);
 vec3 pow_vec3(vec3 x, vec3 n);
 vec4 pow_vec4(vec4 x, vec4 n);
+dvec2 pow_dvec2(dvec2 x, dvec2 n);
+dvec4 pow_dvec4(dvec4 x, dvec4 n);
 
 
 // Trigonometric sine, `sin(x)`. Over inputs in [-2 pi, 2 pi], maximum error of
@@ -1126,6 +1158,24 @@ vec3 quat_apply(quat q, vec3 v);
         , default: (const char*[isvec3(a) == isvec3(b)])    \
             {"vec3 IS ONLY COMPATIBLE WITH OTHER vec3"}     \
     )
+// Same as `choose_all_2_`, but also dispatching the double-precision vectors.
+#define choose_alld_2_(f, a, b) generic(0                   \
+        , int: generic(distinguish_vec3(a + b)              \
+            ,            i32: GLUE2(f, _i32)                \
+            ,            i64: GLUE2(f, _i64)                \
+            ,            u32: GLUE2(f, _u32)                \
+            ,            u64: GLUE2(f, _u64)                \
+            ,            f32: GLUE2(f, _f32)                \
+            ,            f64: GLUE2(f, _f64)                \
+            ,           vec2: GLUE2(f, _vec2)               \
+            , genuinely_vec3: GLUE2(f, _vec3)               \
+            ,           vec4: GLUE2(f, _vec4)               \
+            ,          dvec2: GLUE2(f, _dvec2)              \
+            ,          dvec4: GLUE2(f, _dvec4)              \
+        ) (a, b)                                            \
+        , default: (const char*[isvec3(a) == isvec3(b)])    \
+            {"vec3 IS ONLY COMPATIBLE WITH OTHER vec3"}     \
+    )
 #define choose_all_3_(f, a, b, c) generic(0                 \
         , int: generic(distinguish_vec3(a + b + c)          \
             ,            i32: GLUE2(f, _i32)                \
@@ -1205,6 +1255,31 @@ vec3 quat_apply(quat q, vec3 v);
             {"vec3 IS ONLY COMPATIBLE WITH OTHER vec3"}     \
     )
 
+// Same as `choose_fp_N_`, but also dispatching the double-precision vectors.
+#define choose_fpd_1_(f, a)                 \
+    generic(distinguish_vec3(a)             \
+        ,            f64: GLUE2(f, _f64)    \
+        ,            f32: GLUE2(f, _f32)    \
+        ,           vec2: GLUE2(f, _vec2)   \
+        , genuinely_vec3: GLUE2(f, _vec3)   \
+        ,           vec4: GLUE2(f, _vec4)   \
+        ,          dvec2: GLUE2(f, _dvec2)  \
+        ,          dvec4: GLUE2(f, _dvec4)  \
+    ) (a)
+#define choose_fpd_2_(f, a, b) generic(0                    \
+        , int: generic(distinguish_vec3(a + b)              \
+            ,            f64: GLUE2(f, _f64)                \
+            ,            f32: GLUE2(f, _f32)                \
+            ,           vec2: GLUE2(f, _vec2)               \
+            , genuinely_vec3: GLUE2(f, _vec3)               \
+            ,           vec4: GLUE2(f, _vec4)               \
+            ,          dvec2: GLUE2(f, _dvec2)              \
+            ,          dvec4: GLUE2(f, _dvec4)              \
+        ) (a, b)                                            \
+        , default: (const char*[isvec3(a) == isvec3(b)])    \
+            {"vec3 IS ONLY COMPATIBLE WITH OTHER vec3"}     \
+    )
+
 #define choose_fpscal_1_(f, a)  \
     generic(a                   \
         , f64: GLUE2(f, _f64)   \
@@ -1,6 +1,7 @@
 #include "optim.h"
 
 #include "maths.h"
+#include "profile.h"
 
 
 // =========================================================================== //
@@ -19,15 +20,39 @@ static f64 opt_1D_cost_(opt_cost_f cost, void* rstr user, i64 count,
 #define get_1D_cost(phi) \
     ( opt_1D_cost_(cost, user, count, tmp, r, m, (phi)) )
 
+// Evaluates the `n` independent points `phis`, batched if possible.
+static void opt_1D_costs_(opt_cost_f cost, opt_costs_f* costs, void* rstr user,
+        i64 count, f64* rstr tmp, const f64* rstr r, const f64* rstr m, i32 n,
+        const f64* rstr phis, f64* rstr fs) {
+    assert(n <= OPT_BATCH, "n=%d", n);
+    if (costs == NULL) {
+        for (i32 k=0; k<n; ++k)
+            fs[k] = opt_1D_cost_(cost, user, count, tmp, r, m, phis[k]);
+        return;
+    }
+    const f64* params[OPT_BATCH];
+    for (i32 k=0; k<n; ++k) {
+        f64* x = tmp + k*count;
+        for (i64 i=0; i<count; ++i)
+            x[i] = r[i] + phis[k]*m[i];
+        params[k] = x;
+    }
+    costs(n, params, user, fs);
+}
+#define get_1D_costs(n, phis, fs) \
+    ( opt_1D_costs_(cost, costs, user, count, tmp, r, m, (n), (phis), (fs)) )
+
 
-void opt_bracket1D(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
-        const f64* rstr r, const f64* rstr m, f64 phi0, f64 phistep,
-        f64* rstr philo, f64* rstr phihi) {
+void opt_bracket1D(opt_cost_f cost, opt_costs_f* costs, void* rstr user,
+        i64 count, void* rstr tmp, const f64* rstr r, const f64* rstr m,
+        f64 phi0, f64 phistep, f64* rstr philo, f64* rstr phihi) {
 
     f64 phia = phi0;
     f64 phib = phi0 + phistep;
-    f64 fa = get_1D_cost(phia);
-    f64 fb = get_1D_cost(phib);
+    f64 fab[2];
+    get_1D_costs(2, ((f64[2]){ phia, phib }), fab);
+    f64 fa = fab[0];
+    f64 fb = fab[1];
 
     // ooo might be flat.
     if (nearto(fa, fb)) {
@@ -71,17 +96,19 @@ void opt_bracket1D(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
 }
 
 
-f64 opt_run1D(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
-        const f64* rstr r, const f64* rstr m, f64 philo, f64 phihi,
-        f64 rtol, f64 atol,
+f64 opt_run1D(opt_cost_f cost, opt_costs_f* costs, void* rstr user,
+        i64 count, void* rstr tmp, const f64* rstr r, const f64* rstr m,
+        f64 philo, f64 phihi, f64 rtol, f64 atol,
         f64* rstr best_cost) {
 
     f64 phi0 = 0.5*(philo + phihi); // first best (init to guess).
     f64 phi1 = philo; // second best.
     f64 phi2 = phihi; // third best.
-    f64 f0 = get_1D_cost(phi0);
-    f64 f1 = get_1D_cost(phi1);
-    f64 f2 = get_1D_cost(phi2);
+    f64 f012[3];
+    get_1D_costs(3, ((f64[3]){ phi0, phi1, phi2 }), f012);
+    f64 f0 = f012[0];
+    f64 f1 = f012[1];
+    f64 f2 = f012[2];
 
     if (f2 < f1) {
         swap(phi1, phi2);
@@ -208,13 +235,13 @@ f64 opt_run1D(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
 
 
 
-i32 opt_run(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
-        f64 ftol, f64 xtol, f64* rstr x, f64* rstr best_cost) {
-    /* first `count` elements used for temp state vectors. */
-    f64* xprev    = (f64*)tmp + 1*count;
-    f64* netdir   = (f64*)tmp + 2*count;
-    i64* sorting  = (i64*)tmp + 3*count;
-    f64* searches = (f64*)tmp + 4*count;
+i32 opt_run(opt_cost_f cost, opt_costs_f* costs, void* rstr user, i64 count,
+        void* rstr tmp, f64 ftol, f64 xtol, f64* rstr x, f64* rstr best_cost) {
+    /* first `OPT_BATCH*count` elements used for temp state vectors. */
+    f64* xprev    = (f64*)tmp + (OPT_BATCH + 0)*count;
+    f64* netdir   = (f64*)tmp + (OPT_BATCH + 1)*count;
+    i64* sorting  = (i64*)tmp + (OPT_BATCH + 2)*count;
+    f64* searches = (f64*)tmp + (OPT_BATCH + 3)*count;
 
     // `xprev` left uninitialised.
     // `netdir` left uninitialised.
@@ -239,6 +266,8 @@ i32 opt_run(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
     i32 was_reset = 0;
 
     for (i32 iter=0; iter<OPT_MAXITERS_; ++iter) /* safety */ {
+        PROFILE_ITERS(PROFILE_optimise, 1);
+        COUNT_ADD(optimiser_iters, 1);
 
         // Firstly, minimise along each search, adding to the previous searches
         // improvements.
@@ -249,7 +278,7 @@ i32 opt_run(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
             f64* m = searches + count*sorting[dir];
 
             f64 philo, phihi;
-            opt_bracket1D(cost, user, count, tmp,
+            opt_bracket1D(cost, costs, user, count, tmp,
                     x, m, 0.0, min(1.0, prev_netdir_mag/4),
                     &philo, &phihi
                 );
@@ -257,7 +286,7 @@ i32 opt_run(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
                 return 0;
 
             f64 new_cost;
-            f64 phi = opt_run1D(cost, user, count, tmp,
+            f64 phi = opt_run1D(cost, costs, user, count, tmp,
                     x, m, philo, phihi,
                     0.0, xtol,
                     &new_cost
@@ -298,14 +327,14 @@ i32 opt_run(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
             // Accelerate search by doing an additional line search along this
             // new direction.
             f64 philo, phihi;
-            opt_bracket1D(cost, user, count, tmp,
+            opt_bracket1D(cost, costs, user, count, tmp,
                     x, netdir, 0.0, min(1.0, prev_netdir_mag/4),
                     &philo, &phihi
                 );
             if (isnan(philo + phihi))
                 return 0;
 
-            f64 phi = opt_run1D(cost, user, count, tmp,
+            f64 phi = opt_run1D(cost, costs, user, count, tmp,
                     x, netdir, philo, phihi,
                     0.0, xtol,
                     &new_cost
@@ -9,45 +9,56 @@
 
 typedef f64 opt_cost_f(const f64* rstr params, void* rstr user);
 
+// Batched cost, setting `costs[i]` to the cost of `params[i]` for each of the
+// `n` candidates (at most `OPT_BATCH`). Must behave as if `opt_cost_f` was
+// called on each candidate in order. Only candidates which don't depend on each
+// other are batched, so the minimisers still make most calls one at a time.
+typedef void opt_costs_f(i32 n, const f64* const* params, void* rstr user,
+        f64* rstr costs);
+#define OPT_BATCH (3)
+
 
 // Find an interval [`philo`, `phihi`] around `phi0` (not necessarily enclosing
 // it), using steps proportional to `phistep`. This interval will be nan if
 // bracketing failed, otherwise it will contain a local minimum of
 // `cost(r + phi*m)` over `phi`.
+// - `costs` may be null, otherwise it's used for independent evaluations.
 // - `tmp` must point to `OPT_BRACKET1D_MEMSIZE(count)` bytes.
 // - `r` and `m` must point to `count` elements, representing state vector
 //      constants.
-void opt_bracket1D(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
-        const f64* rstr r, const f64* rstr m, f64 phi0, f64 phistep,
-        f64* rstr philo, f64* rstr phihi);
-#define OPT_BRACKET1D_MEMSIZE(count) (8*(count))
+void opt_bracket1D(opt_cost_f cost, opt_costs_f* costs, void* rstr user,
+        i64 count, void* rstr tmp, const f64* rstr r, const f64* rstr m,
+        f64 phi0, f64 phistep, f64* rstr philo, f64* rstr phihi);
+#define OPT_BRACKET1D_MEMSIZE(count) (8*OPT_BATCH*(count))
 
 
 // Bracketed 1D function minimiser (Brent's method). Finds `phi` in
 // [`philo`, `phihi`] s.t. `cost(r + phi*m)` is locally minimised.
+// - `costs` may be null, otherwise it's used for independent evaluations.
 // - `tmp` must point to `OPT_RUN1D_MEMSIZE(count)` bytes.
 // - `r` and `m` must point to `count` elements, representing state vector
 //      constants.
 // - If `best_cost` is not null, it will be set to the minimised cost.
-f64 opt_run1D(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
-        const f64* rstr r, const f64* rstr m, f64 philo, f64 phihi,
-        f64 rtol, f64 atol,
+f64 opt_run1D(opt_cost_f cost, opt_costs_f* costs, void* rstr user,
+        i64 count, void* rstr tmp, const f64* rstr r, const f64* rstr m,
+        f64 philo, f64 phihi, f64 rtol, f64 atol,
         f64* rstr best_cost);
-#define OPT_RUN1D_MEMSIZE(count) (8*(count))
+#define OPT_RUN1D_MEMSIZE(count) (8*OPT_BATCH*(count))
 
 
 // Seeded N-dimensional function minimiser (Powell's method). Takes `x` as a seed
 // for the initial state and in-place modifies it until a local minimum is found
 // (or it fails). On success, guarantees that the most recent call to `cost` was
 // with the optimal `x`.
+// - `costs` may be null, otherwise it's used for independent evaluations.
 // - `tmp` must point to `OPT_RUN_MEMSIZE(count)` bytes.
 // - `x` must point to `count` elements, as a seeding state vector.
 // - If `best_cost` is not null, it will be set to the minimised cost.
 // - Returns non-zero if a minimum was successfully (approximately) found, zero
 //      otherwise (failure).
-i32 opt_run(opt_cost_f cost, void* rstr user, i64 count, void* rstr tmp,
-        f64 ftol, f64 xtol, f64* rstr x, f64* rstr best_cost);
-#define OPT_RUN_MEMSIZE(count) (8*(count)*((count) + 4))
+i32 opt_run(opt_cost_f cost, opt_costs_f* costs, void* rstr user, i64 count,
+        void* rstr tmp, f64 ftol, f64 xtol, f64* rstr x, f64* rstr best_cost);
+#define OPT_RUN_MEMSIZE(count) (8*(count)*((count) + OPT_BATCH + 3))
 
 
 
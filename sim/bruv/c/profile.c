@@ -0,0 +1,57 @@
+#include "profile.h"
+
+#include "assertion.h"
+
+
+
+// =========================================================================== //
+// = PROFILER ================================================================ //
+// =========================================================================== //
+
+_Thread_local profileCounter profile_counters_[PROFILE_COUNT];
+_Thread_local i64 profile_counts_[COUNT_COUNT];
+
+void profile_counts_merge(const i64* counts) {
+    #define PROFILE_MERGE_SUM_(a, b) ((a) + (b))
+    #define PROFILE_MERGE_MAX_(a, b) (((a) > (b)) ? (a) : (b))
+    #define Z(name, merge)                                              \
+        profile_counts_[COUNT_##name] = PROFILE_MERGE_##merge##_(       \
+                profile_counts_[COUNT_##name], counts[COUNT_##name]);
+    PROFILE_COUNTS(Z)
+    #undef Z
+    #undef PROFILE_MERGE_SUM_
+    #undef PROFILE_MERGE_MAX_
+}
+
+void profile_reset(void) {
+    for (i32 i=0; i<PROFILE_COUNT; ++i)
+        profile_counters_[i] = (profileCounter){0};
+    for (i32 i=0; i<COUNT_COUNT; ++i)
+        profile_counts_[i] = 0;
+}
+
+#ifndef _WIN32
+// posix function expose without the import cause fuck that.
+i32 clock_gettime(i32 clock, struct timespec* ts);
+f64 profile_now(void) {
+    struct timespec ts;
+    clock_gettime(1 /* CLOCK_MONOTONIC */, &ts);
+    return (f64)ts.tv_sec + 1e-9 * (f64)ts.tv_nsec;
+}
+#else
+// windows function expose without the import cause fuck that.
+__declspec(dllimport) i32 __stdcall QueryPerformanceCounter(i64* count);
+__declspec(dllimport) i32 __stdcall QueryPerformanceFrequency(i64* freq);
+f64 profile_now(void) {
+    // Fixed at boot, so racing to cache it is harmless.
+    static f64 frequency = 0.0;
+    if (frequency == 0.0) {
+        i64 freq;
+        assert(QueryPerformanceFrequency(&freq), "failed");
+        frequency = (f64)freq;
+    }
+    i64 count;
+    assert(QueryPerformanceCounter(&count), "failed");
+    return (f64)count / frequency;
+}
+#endif
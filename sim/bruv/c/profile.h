@@ -0,0 +1,106 @@
+#pragma once
+#include "br.h"
+
+
+// Hot-path zone profiler for the simulator, in the image of deci's telemetry.
+// Only compiled in when `SIM_PROFILE` is set (build with `-DSIM_PROFILE=1`),
+// otherwise every zone is free and reports zero.
+#ifndef SIM_PROFILE
+  #define SIM_PROFILE 0
+#endif
+
+// Every zone, by name. Takes the macro to apply to each (rather than the usual
+// `X`) so that it may be pasted inside other x-lists. The iteration count of a
+// zone is:
+//   optimise    - optimiser iterations.
+//   fu0_loop    - manifold pressure fixed point steps.
+//   stress      - stations.
+// and unused for the rest (the inner solver iterations are counted below).
+#define PROFILE_ZONES(Z)                                        \
+    Z(execute)                                                  \
+    Z(optimise)                                                 \
+    Z(combustion)                                               \
+    Z(contour)                                                  \
+    Z(fu0_loop)                                                 \
+    Z(march)                                                    \
+    Z(wall)                                                     \
+    Z(colebrook)                                                \
+    Z(isentropic)                                               \
+    Z(stress)                                                   \
+    Z(outputs)                                                  \
+
+typedef enum profileZone {
+    #define PROFILE_ENUM_(name) PROFILE_##name,
+    PROFILE_ZONES(PROFILE_ENUM_)
+    #undef PROFILE_ENUM_
+    PROFILE_COUNT
+} profileZone;
+
+typedef struct profileCounter {
+    f64 time; // [s] total spent within.
+    i64 hits; // times entered.
+    i64 iters; // zone-specific iteration count.
+} profileCounter;
+
+// Counters of the current thread (so the thermal worker threads only count
+// towards whatever zone the calling thread is within).
+extern _Thread_local profileCounter profile_counters_[PROFILE_COUNT];
+
+
+
+// Operation counts, which unlike the zones are always compiled in. Being exact,
+// they catch algorithmic regressions where timing is too noisy to. Each is
+// given with how the counts of separate threads combine (`SUM` or `MAX`).
+#define PROFILE_COUNTS(Z)                                       \
+    Z(optimiser_iters, SUM)                                     \
+    Z(marches, SUM)                                             \
+    Z(wall_iters, SUM)                                          \
+    Z(wall_iters_max, MAX)                                      \
+    Z(colebrook_iters, SUM)                                     \
+    Z(isentropic_iters, SUM)                                    \
+    Z(mach_for_temperature_iters, SUM)                          \
+    Z(cea_lookups, SUM)                                         \
+    Z(ipa_lookups, SUM)                                         \
+    Z(ethanol_lookups, SUM)                                     \
+
+typedef enum profileCountId {
+    #define PROFILE_ENUM_(name, merge) COUNT_##name,
+    PROFILE_COUNTS(PROFILE_ENUM_)
+    #undef PROFILE_ENUM_
+    COUNT_COUNT
+} profileCountId;
+
+// Counts of the current thread.
+extern _Thread_local i64 profile_counts_[COUNT_COUNT];
+
+#define COUNT_ADD(name, n) (profile_counts_[COUNT_##name] += (n))
+#define COUNT_MAX(name, n) do {                                 \
+        i64 _n = (n);                                           \
+        if (_n > profile_counts_[COUNT_##name])                 \
+            profile_counts_[COUNT_##name] = _n;                 \
+    } while (0)
+
+// Combines the given counts (of some other thread) into the current thread's.
+void profile_counts_merge(const i64* counts);
+
+
+// Zeroes every zone and count of the current thread.
+void profile_reset(void);
+
+// Returns a monotonic time, in seconds.
+f64 profile_now(void);
+
+// Times the following statement/block as the given zone (which must be exited
+// normally, no `break`/`return`/`goto` out of it, or it goes unrecorded).
+#if SIM_PROFILE
+#define PROFILE_ZONE(zone)                                              \
+    for (f64 _start=profile_now(), _once = 1;                           \
+         _once;                                                         \
+         profile_counters_[(zone)].time += profile_now() - _start,      \
+         profile_counters_[(zone)].hits++,                              \
+         _once = 0)
+#define PROFILE_ITERS(zone, n) (profile_counters_[(zone)].iters += (n))
+#else
+#define PROFILE_ZONE(zone) for (i32 _once=1; _once; _once=0)
+#define PROFILE_ITERS(zone, n) ((void)0)
+#endif
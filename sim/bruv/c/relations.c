@@ -1,6 +1,10 @@
 #include "relations.h"
 
+#include <pthread.h>
+
+#include "lut.h"
 #include "maths.h"
+#include "profile.h"
 
 
 SpecificHeatRatio* init_shr(SpecificHeatRatio* shr, f64 gamma) {
@@ -15,38 +19,119 @@ SpecificHeatRatio* init_shr(SpecificHeatRatio* shr, f64 gamma) {
 }
 
 
-static f64 isentropic_M_newton_raphson(f64 M, f64 A_on_Astar,
+static f64 isentropic_M_newton_step(f64 M, f64 A_on_Astar,
         const SpecificHeatRatio* shr) {
     // Find M s.t.:
     //  A_on_Astar = isentropic_A_on_Astar(M)
     //  0 = isentropic_A_on_Astar(M) - A_on_Astar
     //  0 = f(M)
+    f64 term = 2.0/(shr->y + 1.0) + sqed(M)/shr->n/2.0;
+    f64 f = pow(term, shr->n) / M - A_on_Astar;
+    f64 df = pow(term, shr->n - 1.0)
+           * (1.0 - 1.0/sqed(M))
+           * 2.0/(shr->y + 1.0);
+    return M - f/df;
+}
+
+static f64 isentropic_M_newton_raphson(f64 M, f64 A_on_Astar,
+        const SpecificHeatRatio* shr) {
     for (i32 iter=0; /* true */; ++iter) {
         enum { MAX_ITERS = 20 };
-        f64 term = 2.0/(shr->y + 1.0) + sqed(M)/shr->n/2.0;
-        f64 f = pow(term, shr->n) / M - A_on_Astar;
-        f64 df = pow(term, shr->n - 1.0)
-               * (1.0 - 1.0/sqed(M))
-               * 2.0/(shr->y + 1.0);
-        if (iterstep(&M, M - f/df) < 1e-8)
+        if (iterstep(&M, isentropic_M_newton_step(M, A_on_Astar, shr)) < 1e-8)
             break;
         assert(iter < MAX_ITERS, "failed to converge");
     }
     return M;
 }
 
+
+// Inverse area ratio table, giving mach over gamma and the signed
+// `sqrt(log2(A/A*))` (negative for subsonic). Mach is smooth in this coordinate
+// straight through the throat, so both branches share the one table. Covers
+// typical combustion gas gammas and area ratios up to 16, with an extra cell of
+// padding on each side so the edge cells still see a full bicubic stencil.
+#define ISEN_TBL_GAMMA_LEN (32)
+#define ISEN_TBL_GAMMA_LO (1.05)
+#define ISEN_TBL_GAMMA_HI (1.45)
+#define ISEN_TBL_U_LEN (64)
+#define ISEN_TBL_U_MAX (2.0) // sqrt(log2(16))
+static f32 isen_tbl_[ISEN_TBL_GAMMA_LEN * ISEN_TBL_U_LEN];
+// Built on first use, by whichever thread gets there first.
+static pthread_once_t isen_tbl_once_ = PTHREAD_ONCE_INIT;
+
+static f64 isen_tbl_gamma_pad_(void) {
+    return (ISEN_TBL_GAMMA_HI - ISEN_TBL_GAMMA_LO) / (ISEN_TBL_GAMMA_LEN - 3);
+}
+static f64 isen_tbl_u_pad_(void) {
+    return 2.0*ISEN_TBL_U_MAX / (ISEN_TBL_U_LEN - 3);
+}
+
+static void isen_tbl_build_(void) {
+    f64 glo = ISEN_TBL_GAMMA_LO - isen_tbl_gamma_pad_();
+    f64 ghi = ISEN_TBL_GAMMA_HI + isen_tbl_gamma_pad_();
+    f64 ulo = -ISEN_TBL_U_MAX - isen_tbl_u_pad_();
+    f64 uhi = +ISEN_TBL_U_MAX + isen_tbl_u_pad_();
+    for (i32 i=0; i<ISEN_TBL_GAMMA_LEN; ++i) {
+        SpecificHeatRatio* shr = get_shr(lerpidx(glo, ghi, i,
+                ISEN_TBL_GAMMA_LEN));
+        for (i32 j=0; j<ISEN_TBL_U_LEN; ++j) {
+            f64 u = lerpidx(ulo, uhi, j, ISEN_TBL_U_LEN);
+            f64 A_on_Astar = exp2(sqed(u));
+            // Bisect rather than trust the seeds out here, A/A* is monotonic
+            // on each branch.
+            f64 lo = (u < 0.0) ? 1e-6 : 1.0;
+            f64 hi = (u < 0.0) ? 1.0 : 50.0;
+            for (i32 iter=0; iter<64; ++iter) {
+                f64 mid = 0.5*(lo + hi);
+                i32 above = isentropic_A_on_Astar(mid, shr) > A_on_Astar;
+                if (above == (u < 0.0))
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            isen_tbl_[ISEN_TBL_U_LEN*i + j] = (f32)(0.5*(lo + hi));
+        }
+    }
+}
+
+// Returns zero if outside the table, otherwise sets `M` from the table plus a
+// single newton polish.
+static i32 isentropic_M_from_table(f64* rstr M, i32 subsonic, f64 A_on_Astar,
+        const SpecificHeatRatio* shr) {
+    f64 u = sqrt(log2(A_on_Astar));
+    if (!within(shr->y, ISEN_TBL_GAMMA_LO, ISEN_TBL_GAMMA_HI))
+        return 0;
+    if (!(u <= ISEN_TBL_U_MAX))
+        return 0;
+    pthread_once(&isen_tbl_once_, isen_tbl_build_);
+    if (subsonic)
+        u = -u;
+    f64 gpad = isen_tbl_gamma_pad_();
+    f64 upad = isen_tbl_u_pad_();
+    f64 t = (shr->y - ISEN_TBL_GAMMA_LO + gpad)
+          / (ISEN_TBL_GAMMA_HI - ISEN_TBL_GAMMA_LO + 2.0*gpad);
+    f64 s = (u + ISEN_TBL_U_MAX + upad) / (2.0*ISEN_TBL_U_MAX + 2.0*upad);
+    f64 M0 = lut_catmullrom(isen_tbl_, ISEN_TBL_GAMMA_LEN, ISEN_TBL_U_LEN, t,
+            s);
+    *M = isentropic_M_newton_step(M0, A_on_Astar, shr);
+    return 1;
+}
+
 f64 isentropic_sup_M(f64 A_on_Astar, const SpecificHeatRatio* shr) {
     // Gotta find by inverting the M -> A/Astar relation. I dont believe this has
-    // a simple inverse, so we guess then root find.
+    // a simple inverse, so we guess (or look up) then root find.
 
     assert(A_on_Astar >= 1.0, "A_on_Astar cannot be <1, got %f", A_on_Astar);
     if (A_on_Astar <= 1.0 + 1e-8)
         return 1.0;
+    f64 M;
+    if (isentropic_M_from_table(&M, 0, A_on_Astar, shr))
+        return M;
     // Pretty mid initial seed smile.
     // https://www.desmos.com/calculator/jvhdhh0q4s
-    f64 M = 1.0
-          + 0.7*shr->y*pow(A_on_Astar - 1.0, shr->sup_M_seed_n)
-          + shr->sup_M_seed_m*(A_on_Astar - 1.0);
+    M = 1.0
+      + 0.7*shr->y*pow(A_on_Astar - 1.0, shr->sup_M_seed_n)
+      + shr->sup_M_seed_m*(A_on_Astar - 1.0);
     return isentropic_M_newton_raphson(M, A_on_Astar, shr);
 }
 
@@ -54,10 +139,13 @@ f64 isentropic_sub_M(f64 A_on_Astar, const SpecificHeatRatio* shr) {
     assert(A_on_Astar >= 1.0, "A_on_Astar cannot be <1, got %f", A_on_Astar);
     if (A_on_Astar <= 1.0 + 1e-8)
         return 1.0;
+    f64 M;
+    if (isentropic_M_from_table(&M, 1, A_on_Astar, shr))
+        return M;
     // Pretty bloody average seed smillleee.
     // https://www.desmos.com/calculator/xzohdrgmja
-    f64 M = 1.0
-          / (1.0 + pow(shr->sub_M_seed_m*(A_on_Astar - 1.0), shr->sub_M_seed_n));
+    M = 1.0
+      / (1.0 + pow(shr->sub_M_seed_m*(A_on_Astar - 1.0), shr->sub_M_seed_n));
     return isentropic_M_newton_raphson(M, A_on_Astar, shr);
 }
 
@@ -71,20 +159,40 @@ f64 isentropic_M(i32 subsonic, f64 A_on_Astar,
 
 void isentropic_shr_M(SpecificHeatRatio* shr, f64* rstr M, i32 subsonic,
         f64 A_on_Astar, const ceaFit* fit_gamma, f64 seed_gamma) {
-    // gamma and mach are dep. on each other, simple fixed-point iteration to
-    // numerically solve. Guess initial seed (throat is a good guess).
+    // gamma and mach are dep. on each other, so solve both at once. Substitute
+    // gamma = gamma(M) (which the fit gives the derivative of) and newton
+    // iterate on mach alone, i.e. find M s.t.:
+    //  0 = isentropic_A_on_Astar(M, gamma(M)) - A_on_Astar
+    // Seed from the inversion at a guessed gamma (throat is a good guess).
     init_shr(shr, seed_gamma);
     *M = isentropic_M(subsonic, A_on_Astar, shr);
-    for (i32 iter=0; /* true */; ++iter) {
-        enum { MAX_ITERS = 100 };
+    if (A_on_Astar <= 1.0 + 1e-8) {
+        init_shr(shr, cea_sample(fit_gamma, *M));
+        return;
+    }
+    PROFILE_ZONE(PROFILE_isentropic) for (i32 iter=0; /* true */; ++iter) {
+        enum { MAX_ITERS = 20 };
+        COUNT_ADD(isentropic_iters, 1);
 
-        f64 gamma = cea_sample(fit_gamma, *M);
-        init_shr(shr, gamma);
-        f64 new_M = isentropic_M(subsonic, A_on_Astar, shr);
+        f64 y = cea_sample(fit_gamma, *M);
+        f64 dydM = cea_sample_dM(fit_gamma, *M);
+        f64 n = 0.5*(y + 1.0)/(y - 1.0);
+        f64 term = 2.0/(y + 1.0) + sqed(*M)/n/2.0;
+        f64 A = pow(term, n) / *M;
+        // Partials of log(A/A*), wrt mach and gamma.
+        f64 dlnA_dM = (sqed(*M) - term) / (*M * term);
+        f64 dlnA_dy = -LN2*log2(term)/sqed(y - 1.0)
+                    + 2.0*n*(sqed(*M) - 1.0)/sqed(y + 1.0)/term;
+        f64 df = A*(dlnA_dM + dlnA_dy*dydM);
+        f64 new_M = *M - (A - A_on_Astar)/df;
+        // Dont let it hop branches.
+        if ((subsonic) ? (new_M >= 1.0 || new_M <= 0.0) : (new_M <= 1.0))
+            new_M = 0.5*(*M + 1.0);
         if (iterstep(M, new_M) < 1e-8)
             break;
         assert(iter < MAX_ITERS, "failed to converge");
     }
+    init_shr(shr, cea_sample(fit_gamma, *M));
 }
 
 
@@ -137,8 +245,9 @@ f64 friction_factor_colebrook(f64 Re, f64 D, f64 eps) {
         return 1.0/sqed(1.82*LOG10TWO*log2(Re) - 1.64);
     assert(Re > 2300.0, "non-turbulent flow: Re=%g", Re);
     f64 ff = friction_factor_haaland(Re, D, eps); // guess.
-    for (i32 iter=0; /* true */; ++iter) {
+    PROFILE_ZONE(PROFILE_colebrook) for (i32 iter=0; /* true */; ++iter) {
         enum { MAX_ITERS = 1000 };
+        COUNT_ADD(colebrook_iters, 1);
         f64 x = -2.0*LOG10TWO*log2(eps/D/3.71 + 2.52/Re/sqrt(ff));
         if (iterstep(&ff, 1.0 / sqed(x)) < 1e-8)
             break;
@@ -147,6 +256,35 @@ f64 friction_factor_colebrook(f64 Re, f64 D, f64 eps) {
     return ff;
 }
 
+f64 friction_factor_serghides(f64 Re, f64 D, f64 eps) {
+    if (eps == 0.0)
+        return 1.0/sqed(1.82*LOG10TWO*log2(Re) - 1.64);
+    assert(Re > 2300.0, "non-turbulent flow: Re=%g", Re);
+    // Steffensen-accelerated colebrook fixed point, in terms of 1/sqrt(ff).
+    f64 A = -2.0*LOG10TWO*log2(eps/D/3.71 + 12.0/Re);
+    f64 B = -2.0*LOG10TWO*log2(eps/D/3.71 + 2.52*A/Re);
+    f64 C = -2.0*LOG10TWO*log2(eps/D/3.71 + 2.52*B/Re);
+    return 1.0/sqed(A - sqed(B - A)/(C - 2.0*B + A));
+}
+
+f64 friction_factor_goudar_sonnad(f64 Re, f64 D, f64 eps) {
+    if (eps == 0.0)
+        return 1.0/sqed(1.82*LOG10TWO*log2(Re) - 1.64);
+    assert(Re > 2300.0, "non-turbulent flow: Re=%g", Re);
+    // Colebrook rearranged into a lambert-w form, then approximated via a
+    // corrected series expansion. See Goudar & Sonnad (2008).
+    f64 a = 2.0/LN10;
+    f64 b = eps/D/3.71;
+    f64 d = LN10*Re/(2.0*2.52);
+    f64 s = b*d + LN2*log2(d);
+    f64 q = pow(s, s/(s + 1.0));
+    f64 g = b*d + LN2*log2(d/q);
+    f64 z = LN2*log2(q/g);
+    f64 dLA = z*g/(g + 1.0);
+    f64 dCFA = dLA*(1.0 + 0.5*z/(sqed(g + 1.0) + z/3.0*(2.0*g - 1.0)));
+    return 1.0/sqed(a*(LN2*log2(d/q) + dCFA));
+}
+
 
 f64 nusselt_gnielinski(f64 Re, f64 Pr, f64 ff) {
     return 0.125*ff*(Re - 1000.0)*Pr
@@ -174,6 +312,7 @@ f64 mach_for_temperature(f64 T_on_T0, const ceaFit* fit_gamma) {
     f64 M = 1.0; // guess.
     for (i32 iter=0; /* true */; ++iter) {
         enum { MAX_ITERS = 100 };
+        COUNT_ADD(mach_for_temperature_iters, 1);
         f64 gamma = cea_sample(fit_gamma, M);
         f64 new_M = sqrt(2.0 / (gamma - 1.0) * (1.0/T_on_T0 - 1.0));
         if (iterstep(&M, new_M) < 1e-5)
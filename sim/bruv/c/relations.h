@@ -49,6 +49,9 @@ f64 viscosity_from_power_law(f64 T, f64 Tref, f64 muref, f64 exponent);
 
 f64 friction_factor_haaland(f64 Re, f64 D, f64 eps);
 f64 friction_factor_colebrook(f64 Re, f64 D, f64 eps);
+// Explicit approximations of `friction_factor_colebrook` (with its constants).
+f64 friction_factor_serghides(f64 Re, f64 D, f64 eps);
+f64 friction_factor_goudar_sonnad(f64 Re, f64 D, f64 eps);
 
 
 f64 nusselt_gnielinski(f64 Re, f64 Pr, f64 ff);
@@ -14,19 +14,94 @@
 
 
 
-// Simulate the engine from inputs.
-static void sim_ulate(simState* rstr s, i32 full_output);
+// Simulate the engine from inputs, marching over the threads of `pool` (which
+// may be null).
+static void sim_ulate(simState* rstr s, thermalPool* pool, i32 full_output);
 enum { NO_FULL_OUTPUT = 0, GIVE_FULL_OUTPUT = 1 };
 
 // Optimise the engine from the given seed inputs.
-static void sim_optimise(simState* rstr s);
+static void sim_optimise(simState* rstr s, thermalPool* pool,
+        c_Progress* progress);
+
+// Writes the profile and counts of this thread to the state.
+static void sim_profile_outputs(simState* rstr s);
 
 void sim_execute(simState* rstr s) {
-    // Optimise system.
-    sim_optimise(s);
+    sim_execute_watched(s, NULL);
+}
+
+// Returns zero if an assertion failed (leaving its message).
+static NEVERINLINE i32 sim_execute_pooled_(simState* rstr s,
+        c_Progress* progress, thermalPool* pool) {
+    if (assertion_has_failed())
+        return 0;
+    PROFILE_ZONE(PROFILE_execute) {
+        // Optimise system.
+        PROFILE_ZONE(PROFILE_optimise)
+            sim_optimise(s, pool, progress);
+
+        // Simulate and write all outputs.
+        sim_ulate(s, pool, GIVE_FULL_OUTPUT);
+    }
+    return 1;
+}
 
-    // Simulate and write all outputs.
-    sim_ulate(s, GIVE_FULL_OUTPUT);
+void sim_execute_watched(simState* rstr s, c_Progress* progress) {
+    profile_reset();
+    // The march threads are kept for the whole execution, so they must be
+    // stopped before passing on any failure.
+    thermalPool* pool = thermal_pool_new(s->thermal_threads);
+    jmp_buf outer;
+    assertion_save(outer);
+    i32 ok = sim_execute_pooled_(s, progress, pool);
+    assertion_restore(outer);
+    thermal_pool_free(pool);
+    if (!ok)
+        assertion_rethrow(assertion_message());
+    sim_profile_outputs(s);
+}
+
+// Simulate several engines together, sharing the coolant march.
+static void sim_ulate_lanes(simState* const* s, i32 count, i32 full_output);
+
+static_assert(SIM_LANES == THERMAL_LANES);
+
+// Returns zero if an assertion failed (leaving its message).
+static NEVERINLINE i32 sim_execute_lanes_pooled_(simState* const* s,
+        i32 count, thermalPool* pool) {
+    if (assertion_has_failed())
+        return 0;
+    PROFILE_ZONE(PROFILE_execute) {
+        // The optimiser is mostly sequential, so each engine is optimised on
+        // its own (batching only its independent candidates).
+        PROFILE_ZONE(PROFILE_optimise) {
+            for (i32 k=0; k<count; ++k)
+                sim_optimise(s[k], pool, NULL);
+        }
+
+        sim_ulate_lanes(s, count, GIVE_FULL_OUTPUT);
+    }
+    return 1;
+}
+
+void sim_execute_lanes(simState* const* s, i32 count) {
+    assert(1 <= count && count <= SIM_LANES, "invalid lane count: %d", count);
+
+    profile_reset();
+    // As in `sim_execute_watched`, with enough threads for any engine.
+    i64 threads = 0;
+    for (i32 k=0; k<count; ++k)
+        threads = max(threads, s[k]->thermal_threads);
+    thermalPool* pool = thermal_pool_new(threads);
+    jmp_buf outer;
+    assertion_save(outer);
+    i32 ok = sim_execute_lanes_pooled_(s, count, pool);
+    assertion_restore(outer);
+    thermal_pool_free(pool);
+    if (!ok)
+        assertion_rethrow(assertion_message());
+    for (i32 k=0; k<count; ++k)
+        sim_profile_outputs(s[k]);
 }
 
 
@@ -52,6 +127,18 @@ c_IH sim_interpretation_hash(void) {
     return h;
 }
 
+static void sim_profile_outputs(simState* rstr s) {
+    #define X(zone)                                                     \
+        s->prof_##zone##_time = profile_counters_[PROFILE_##zone].time;   \
+        s->prof_##zone##_hits = profile_counters_[PROFILE_##zone].hits;   \
+        s->prof_##zone##_iters = profile_counters_[PROFILE_##zone].iters;
+    PROFILE_ZONES(X)
+    #undef X
+    #define X(name, merge) s->count_##name = profile_counts_[COUNT_##name];
+    PROFILE_COUNTS(X)
+    #undef X
+}
+
 
 
 // =========================================================================== //
@@ -59,10 +146,21 @@ c_IH sim_interpretation_hash(void) {
 // =========================================================================== //
 
 static void sim_full_outputs(simState* rstr s, const Contour* cnt,
-        const thermalStation* thermal_stns, i32 thermal_N,
-        const stressStation* stress_stns, i32 stress_N);
-
-static void sim_ulate(simState* rstr s, i32 full_output) {
+        const ContourSampler* thermal_smp, const thermalStation* thermal_stns,
+        const ContourSampler* stress_smp, const stressStation* stress_stns);
+
+// Working state of one simulation, carried between its stages.
+typedef struct simRun_ {
+    Contour cnt;
+    i32 thermal_N;
+    thermalStation* thermal_stns;
+    ContourSampler thermal_smp;
+    stressStation* fused_stress_stns; // null if not fused.
+    thermalBartz bartz;
+} simRun_;
+
+// Everything up to the coolant march, including its setup.
+static void sim_ulate_setup_(simState* rstr s, simRun_* run) {
 
     /* Input validation. */
 
@@ -81,57 +179,70 @@ static void sim_ulate(simState* rstr s, i32 full_output) {
     assert(s->k_pdms > 0.0, "invalid input: k_pdms=%g", s->k_pdms);
     assert(s->th_iw > 0.0, "invalid input: th_iw=%g", s->th_iw);
     assert(s->th_ow > 0.0, "invalid input: th_ow=%g", s->th_ow);
-    assert(s->no_chnl > 0, "invalid input: no_chnl=%g", s->no_chnl);
+    assert(s->no_chnl > 0, "invalid input: no_chnl=%lld", s->no_chnl);
     assert(s->th_chnl > 0.0, "invalid input: th_chnl=%g", s->th_chnl);
     assert(s->prop_chnl > 0.0, "invalid input: prop_chnl=%g", s->prop_chnl);
     assert(s->eps_chnl >= 0.0, "invalid input: eps_chnl=%g", s->eps_chnl);
+    assert(s->friction == FRICTION_COLEBROOK
+        || s->friction == FRICTION_SERGHIDES
+        || s->friction == FRICTION_GOUDAR_SONNAD,
+            "invalid input: friction=%lld", s->friction);
     assert(s->T_fu0 > 0.0, "invalid input: T_fu0=%g", s->T_fu0);
     assert(s->Pr_fu > 1.0, "invalid input: Pr_fu=%g", s->Pr_fu);
+    assert(s->coolant == COOLANT_IPA || s->coolant == COOLANT_ETHANOL,
+            "invalid input: coolant=%lld", s->coolant);
+    assert(s->thermal_threads >= 0, "invalid input: thermal_threads=%lld",
+            s->thermal_threads);
+    assert(s->fused_stress == 0 || s->fused_stress == 1,
+            "invalid input: fused_stress=%lld", s->fused_stress);
 
     assert(s->ofr > 0.0, "invalid input: ofr=%g", s->ofr);
     assert(s->dm_cc > 0.0, "invalid input: dm_cc=%g", s->dm_cc);
     assert(s->P_exit > 0.0, "invalid input: P_exit=%g", s->P_exit);
     assert(s->P0_cc > 0.0, "invalid input: P0_cc=%g", s->P0_cc);
 
-    // Our CEA approximations assume ideally expanded at sea level.
-    assert(nearto(s->P_exit, 101325.0), "invalid input: exit pressure must be "
-            "sea-level atmospheric, got %g", s->P_exit);
+    // Without the altitude tables, our CEA approximations assume ideally
+    // expanded at sea level.
+    assert(cea_has_altitude() || nearto(s->P_exit, 101325.0), "invalid input: "
+            "exit pressure must be sea-level atmospheric, got %g", s->P_exit);
 
 
     /* Combustion */
 
-    s->T0_cc = cea_T0_cc(s->P0_cc, s->ofr);
-    s->rho0_cc = cea_rho0_cc(s->P0_cc, s->ofr);
+    PROFILE_ZONE(PROFILE_combustion) {
+        s->T0_cc = cea_T0_cc(s->P0_cc, s->ofr);
+        s->rho0_cc = cea_rho0_cc(s->P0_cc, s->ofr);
 
-    s->gamma_tht = cea_gamma_tht(s->P0_cc, s->ofr);
-    s->Mw_tht = cea_Mw_tht(s->P0_cc, s->ofr);
-    SpecificHeatRatio* shr_tht = get_shr(s->gamma_tht);
+        s->gamma_tht = cea_gamma_tht(s->P0_cc, s->ofr);
+        s->Mw_tht = cea_Mw_tht(s->P0_cc, s->ofr);
+        SpecificHeatRatio* shr_tht = get_shr(s->gamma_tht);
 
-    s->M_exit = isentropic_M_from_P_on_P0(s->P_exit / s->P0_cc, shr_tht);
-    f64 P_exit = s->P0_cc * isentropic_P_on_P0(s->M_exit, shr_tht);
-    assert(nearto(P_exit, s->P_exit),
-            "failed to find perfectly expanded nozzle?");
-    s->gamma_exit = cea_gamma_exit(s->P0_cc, s->ofr);
+        s->M_exit = isentropic_M_from_P_on_P0(s->P_exit / s->P0_cc, shr_tht);
+        f64 P_exit = s->P0_cc * isentropic_P_on_P0(s->M_exit, shr_tht);
+        assert(nearto(P_exit, s->P_exit),
+                "failed to find perfectly expanded nozzle?");
 
-    s->A_tht = s->dm_cc / s->P0_cc
-             * sqrt(s->T0_cc * GAS_CONSTANT / s->Mw_tht / shr_tht->y)
-             * pow(0.5*(shr_tht->y + 1.0), shr_tht->n);
-    // TODO: ^ move to relations.
+        s->A_tht = s->dm_cc / s->P0_cc
+                 * sqrt(s->T0_cc * GAS_CONSTANT / s->Mw_tht / shr_tht->y)
+                 * pow(0.5*(shr_tht->y + 1.0), shr_tht->n);
+        // TODO: ^ move to relations.
 
-    s->AEAT = isentropic_A_on_Astar(s->M_exit, shr_tht);
-    // TODO: ^ fixed point iterate
+        s->AEAT = isentropic_A_on_Astar(s->M_exit, shr_tht);
+        // TODO: ^ fixed point iterate
+        s->gamma_exit = cea_gamma_exit(s->P0_cc, s->ofr, s->AEAT);
 
-    s->dm_fu = s->dm_cc / (s->ofr + 1.0);
-    s->dm_ox = s->dm_cc - s->dm_fu;
+        s->dm_fu = s->dm_cc / (s->ofr + 1.0);
+        s->dm_ox = s->dm_cc - s->dm_fu;
 
-    s->Isp = cea_Isp(s->P0_cc, s->ofr);
-    s->Thrust = s->Isp * s->dm_cc * STANDARD_GRAVITY;
+        s->Isp = cea_Isp(s->P0_cc, s->ofr, s->AEAT);
+        s->Thrust = s->Isp * s->dm_cc * STANDARD_GRAVITY;
+    }
 
 
     /* Geometry */
 
-    Contour* cnt = &(Contour){0};
-    { // Get chamber contour and find chamber cyl length.
+    Contour* cnt = &run->cnt;
+    PROFILE_ZONE(PROFILE_contour) { // Get chamber contour, fix cyl length.
         f64 V_subsonic = s->A_tht*s->Lstar;
         f64 A_cc = PI * sqed(s->R_cc);
         s->L_cc = V_subsonic / A_cc * 0.8; // guess.
@@ -169,53 +280,197 @@ static void sim_ulate(simState* rstr s, i32 full_output) {
 
     /* Thermals. */
 
-    i32 thermal_N = 500;
-    thermalStation* thermal_stns = malloc(thermal_N * sizeof(thermalStation));
+    i32 thermal_N = 300;
+    run->thermal_N = thermal_N;
+    run->thermal_stns = malloc(thermal_N * sizeof(thermalStation));
+    // The contour is final by now, so its geometry is sampled once for every
+    // coolant march.
+    init_cnt_sampler_clustered(&run->thermal_smp, cnt, thermal_N);
+
+    // When fused, the stresses are evaluated by the coolant march itself, on
+    // the thermal stations.
+    run->fused_stress_stns = NULL;
+    if (s->fused_stress)
+        run->fused_stress_stns = malloc(thermal_N * sizeof(stressStation));
+
+    // Only depends on the combustion, so is shared by every coolant march.
+    thermal_bartz_init(&run->bartz, s);
 
     // Set target fuel injector pressure.
     s->P_fu1 = s->Pr_fu * s->P0_cc;
     // Guess pressure drop at 5 bar.
     s->P_fu0 = s->P_fu1 + 5e5;
-    // Fixed point iterate to dial in ipa manifold pressure.
-    for (i32 iter=0; /* true */; ++iter) {
-        enum { MAX_ITERS = 20 };
-
-        i32 possible = thermal_sim(s, cnt, thermal_stns, thermal_N);
-        f64 T_fu1 = thermal_stns[0].T_c;
-        f64 P_fu1 = thermal_stns[0].P_c;
-        f64 diff = iterstep(&s->P_fu0, s->P_fu1 + s->P_fu0 - P_fu1);
-        if (diff < 1.0 || iter >= MAX_ITERS) {
-            s->possible_system &= possible;
-            s->T_fu1 = T_fu1;
-            s->P_fu1 = P_fu1;
-            break;
-        }
+}
+
+// Takes the result of a coolant march at the current manifold pressure, and
+// steps it (fixed point iterating). Returns non-zero once converged.
+static i32 sim_ulate_march_(simState* rstr s, simRun_* run, i32 iter,
+        i32 possible) {
+    enum { MAX_ITERS = 20 };
+    f64 T_fu1 = run->thermal_stns[0].T_c;
+    f64 P_fu1 = run->thermal_stns[0].P_c;
+    f64 diff = iterstep(&s->P_fu0, s->P_fu1 + s->P_fu0 - P_fu1);
+    if (diff < 1.0 || iter >= MAX_ITERS) {
+        s->possible_system &= possible;
+        s->T_fu1 = T_fu1;
+        s->P_fu1 = P_fu1;
+        return 1;
     }
+    return 0;
+}
 
+// Everything after the coolant march.
+static void sim_ulate_finish_(simState* rstr s, simRun_* run,
+        i32 full_output) {
+    Contour* cnt = &run->cnt;
+    i32 thermal_N = run->thermal_N;
+    thermalStation* thermal_stns = run->thermal_stns;
+    ContourSampler* thermal_smp = &run->thermal_smp;
 
-    /* Stresses. */
 
-    i32 stress_N = 200;
-    stressStation* stress_stns = malloc(stress_N * sizeof(stressStation));
+    /* Stresses. */
 
-    stress_sim(s, cnt, thermal_stns, thermal_N, stress_stns, stress_N);
+    i32 stress_N = 100;
+    stressStation* stress_stns;
+    ContourSampler* stress_smp = &(ContourSampler){0};
+    if (s->fused_stress) {
+        // Already done by the final march.
+        stress_N = thermal_N;
+        stress_stns = run->fused_stress_stns;
+        stress_smp = thermal_smp;
+    } else {
+        stress_stns = malloc(stress_N * sizeof(stressStation));
+        init_cnt_sampler_clustered(stress_smp, cnt, stress_N);
+        PROFILE_ZONE(PROFILE_stress)
+            stress_sim(s, cnt, stress_smp, thermal_smp, thermal_stns,
+                    stress_stns);
+    }
 
-    s->min_SF = +1e6;
-    for (i32 i=0; i<stress_N; ++i)
-        s->min_SF = min(s->min_SF, stress_stns[i].firing.SF);
+    i32 k_SF = stress_min_SF(stress_stns, stress_N);
+    s->min_SF = stress_stns[k_SF].firing.SF;
+    if (k_SF > 0 && k_SF < stress_N - 1) {
+        // The minimum rarely falls on a station, so refine it with the parabola
+        // through the neighbouring stations.
+        f64 zA = stress_smp->z[k_SF - 1];
+        f64 zB = stress_smp->z[k_SF];
+        f64 zC = stress_smp->z[k_SF + 1];
+        f64 fA = stress_stns[k_SF - 1].firing.SF;
+        f64 fB = stress_stns[k_SF].firing.SF;
+        f64 fC = stress_stns[k_SF + 1].firing.SF;
+        f64 dAB = (fB - fA) / (zB - zA);
+        f64 dBC = (fC - fB) / (zC - zB);
+        f64 curv = (dBC - dAB) / (zC - zA); // half the second derivative.
+        if (curv > 0.0) {
+            // f = fB + slope*(z - zB) + curv*(z - zB)^2, at its vertex.
+            f64 slope = dAB + curv*(zB - zA);
+            s->min_SF = min(s->min_SF, fB - sqed(slope)/4.0/curv);
+        }
+    }
 
 
     /* Outputs */
 
-    if (!full_output || s->out_count <= 0)
-        return;
+    if (full_output && s->out_count > 0) {
+        PROFILE_ZONE(PROFILE_outputs)
+            sim_full_outputs(s, cnt, thermal_smp, thermal_stns, stress_smp,
+                    stress_stns);
+    }
+
+    free_cnt_sampler(thermal_smp);
+    if (!s->fused_stress)
+        free_cnt_sampler(stress_smp);
+    free(thermal_stns);
+    free(stress_stns); // also the fused stations.
+}
+
+static void sim_ulate(simState* rstr s, thermalPool* pool, i32 full_output) {
+    simRun_* run = &(simRun_){0};
+    sim_ulate_setup_(s, run);
+
+    // Fixed point iterate to dial in coolant manifold pressure.
+    PROFILE_ZONE(PROFILE_fu0_loop) for (i32 iter=0; /* true */; ++iter) {
+        PROFILE_ITERS(PROFILE_fu0_loop, 1);
+        // Past the first march, only the manifold pressure changes so the
+        // previous march is a good prediction.
+        i32 possible;
+        PROFILE_ZONE(PROFILE_march)
+            possible = thermal_sim(s, &run->cnt, &run->thermal_smp,
+                    &run->bartz, run->thermal_stns, run->fused_stress_stns,
+                    iter > 0, pool);
+        if (sim_ulate_march_(s, run, iter, possible))
+            break;
+    }
+
+    sim_ulate_finish_(s, run, full_output);
+}
+
+// Marches the unconverged designs sharing the coolant and friction factor of
+// `s[first]` together, marking them as `grouped`.
+static void sim_ulate_lanes_march_(simState* const* s, simRun_* runs,
+        i32 count, i32 iter, i32 first, i32* converged, i32* grouped) {
+    thermalLane lanes[SIM_LANES];
+    i32 which[SIM_LANES];
+    i32 n = 0;
+    for (i32 k=first; k<count; ++k) {
+        if (converged[k] || s[k]->coolant != s[first]->coolant
+                || s[k]->friction != s[first]->friction)
+            continue;
+        grouped[k] = 1;
+        which[n] = k;
+        lanes[n++] = (thermalLane){
+            .s = s[k],
+            .cnt = &runs[k].cnt,
+            .smp = &runs[k].thermal_smp,
+            .bartz = &runs[k].bartz,
+            .stns = runs[k].thermal_stns,
+            .stress_stns = runs[k].fused_stress_stns,
+        };
+    }
+    PROFILE_ITERS(PROFILE_fu0_loop, n);
+
+    PROFILE_ZONE(PROFILE_march)
+        thermal_sim_lanes(lanes, n);
 
-    sim_full_outputs(s, cnt, thermal_stns, thermal_N, stress_stns, stress_N);
+    for (i32 j=0; j<n; ++j) {
+        i32 k = which[j];
+        converged[k] = sim_ulate_march_(s[k], &runs[k], iter,
+                lanes[j].possible);
+    }
+}
+
+static void sim_ulate_lanes(simState* const* s, i32 count, i32 full_output) {
+    simRun_ runs[SIM_LANES];
+    for (i32 k=0; k<count; ++k) {
+        runs[k] = (simRun_){0};
+        sim_ulate_setup_(s[k], &runs[k]);
+    }
+
+    // Fixed point iterate every manifold pressure together, with each design
+    // leaving the march once its own has converged. Designs are only marched
+    // together with those of the same coolant and friction factor, since the
+    // march is specialised on them.
+    i32 converged[SIM_LANES] = {0};
+    PROFILE_ZONE(PROFILE_fu0_loop) for (i32 iter=0; /* true */; ++iter) {
+        i32 marched = 0;
+        i32 grouped[SIM_LANES] = {0};
+        for (i32 first=0; first<count; ++first) {
+            if (converged[first] || grouped[first])
+                continue;
+            sim_ulate_lanes_march_(s, runs, count, iter, first, converged,
+                    grouped);
+            ++marched;
+        }
+        if (marched == 0)
+            break;
+    }
+
+    for (i32 k=0; k<count; ++k)
+        sim_ulate_finish_(s[k], &runs[k], full_output);
 }
 
 static void sim_full_outputs(simState* rstr s, const Contour* cnt,
-        const thermalStation* thermal_stns, i32 thermal_N,
-        const stressStation* stress_stns, i32 stress_N) {
+        const ContourSampler* thermal_smp, const thermalStation* thermal_stns,
+        const ContourSampler* stress_smp, const stressStation* stress_stns) {
     assert(s->out_count > 20, "output array is too small (%lld)", s->out_count);
     assert(s->out_z, "null output array: out_z");
     assert(s->out_r, "null output array: out_r");
@@ -268,14 +523,17 @@ static void sim_full_outputs(simState* rstr s, const Contour* cnt,
     ceaFit* fit_cp = &(ceaFit){0};
     ceaFit* fit_mu = &(ceaFit){0};
     ceaFit* fit_Pr = &(ceaFit){0};
-    cea_fit_gamma(fit_gamma, s->P0_cc, s->ofr, s->M_exit);
-    cea_fit_cp(fit_cp, s->P0_cc, s->ofr, s->M_exit);
-    cea_fit_mu(fit_mu, s->P0_cc, s->ofr, s->M_exit);
-    cea_fit_Pr(fit_Pr, s->P0_cc, s->ofr, s->M_exit);
+    cea_fit_gamma(fit_gamma, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_cp(fit_cp, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_mu(fit_mu, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_Pr(fit_Pr, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+
+    ContourSampler* out_smp = &(ContourSampler){0};
+    init_cnt_sampler(out_smp, cnt, s->out_count);
 
     for (i64 i=0; i<s->out_count; ++i) {
-        f64 z = lerpidx(0.0, cnt->z_exit, i, s->out_count);
-        f64 r = cnt_r(cnt, z);
+        f64 z = out_smp->z[i];
+        f64 r = out_smp->r[i];
         f64 A_on_Astar = sqed(r) / sqed(cnt->R_tht);
         SpecificHeatRatio* shr_g = &(SpecificHeatRatio){0};
         f64 M_g;
@@ -301,10 +559,8 @@ static void sim_full_outputs(simState* rstr s, const Contour* cnt,
         s->out_mu_g[i] = mu_g;
         s->out_Pr_g[i] = Pr_g;
         {
-            f64 t = z / cnt->z_exit;
-            t *= thermal_N - 1;
-            i32 k = min(max((i32)t, 0), thermal_N - 2);
-            t -= k;
+            f64 t;
+            i32 k = cnt_sampler_find(thermal_smp, z, &t);
             typeof(thermal_stns) stns = thermal_stns;
             s->out_T_c[i] = lerp(stns[k].T_c, stns[k + 1].T_c, t);
             s->out_P_c[i] = lerp(stns[k].P_c, stns[k + 1].P_c, t);
@@ -323,10 +579,8 @@ static void sim_full_outputs(simState* rstr s, const Contour* cnt,
             s->out_xtra[i] = lerp(stns[k].xtra, stns[k + 1].xtra, t);
         }
         {
-            f64 t = z / cnt->z_exit;
-            t *= stress_N - 1;
-            i32 k = min(max((i32)t, 0), stress_N - 2);
-            t -= k;
+            f64 t;
+            i32 k = cnt_sampler_find(stress_smp, z, &t);
             typeof(stress_stns) stns = stress_stns;
             s->out_startup_sigma[i] = lerp(
                     stns[k].startup.sigma,
@@ -387,14 +641,21 @@ static void sim_full_outputs(simState* rstr s, const Contour* cnt,
     }
 
 
+    free_cnt_sampler(out_smp);
+
+
+    ContourSampler* export_smp = &(ContourSampler){0};
+    init_cnt_sampler(export_smp, cnt, s->export_count);
+
     for (i64 i=0; i<s->export_count; ++i) {
-        f64 z = lerpidx(0.0, cnt->z_exit, i, s->export_count);
-        s->export_z[i] = z;
-        s->export_helix_angle[i] = cnt_helix_angle(cnt, z);
-        s->export_th_chnl[i] = cnt_th_chnl(cnt, z);
-        s->export_psi_chnl[i] = cnt_psi_chnl(cnt, z);
-        s->export_th_iw[i] = cnt_th_iw(cnt, z);
+        s->export_z[i] = export_smp->z[i];
+        s->export_helix_angle[i] = export_smp->helix_angle[i];
+        s->export_th_chnl[i] = export_smp->th_chnl[i];
+        s->export_psi_chnl[i] = export_smp->psi_chnl[i];
+        s->export_th_iw[i] = export_smp->th_iw[i];
     }
+
+    free_cnt_sampler(export_smp);
 }
 
 
@@ -421,6 +682,9 @@ typedef struct simUser {
     // Mapping of "`simParams` index" -> "`params[]` index". If that parameter is
     // not being used, maps to -1.
     i32 mapping[PARAM_COUNT];
+
+    c_Progress* progress; // null if unwatched.
+    thermalPool* pool; // may be null.
 } simUser;
 static void sim_params_from(simUser* u, const f64* rstr params) {
     i32 i;
@@ -459,15 +723,28 @@ static void sim_params_to(const simUser* u, f64* rstr params) {
         params[i] = unbound_both(u->s->prop_chnl, 0.1, 1.0);
 }
 
-static f64 sim_cost(const f64* rstr params, void* rstr user) {
-    simUser* u = user;
+// Publishes one more cost evaluation. Only this thread ever writes the
+// progress, so each field needs only be stored atomically (not updated).
+static void sim_publish_progress(c_Progress* p, f64 cost) {
+    i64 iterations = profile_counts_[COUNT_optimiser_iters];
+    i64 evaluations = __atomic_load_n(&p->evaluations, __ATOMIC_RELAXED) + 1;
+    f64 best_cost;
+    __atomic_load(&p->best_cost, &best_cost, __ATOMIC_RELAXED);
+    if (isnan(best_cost) || cost < best_cost)
+        __atomic_store(&p->best_cost, &cost, __ATOMIC_RELAXED);
+    __atomic_store_n(&p->iterations, iterations, __ATOMIC_RELAXED);
+    __atomic_store_n(&p->evaluations, evaluations, __ATOMIC_RELEASE);
+}
 
-    // Extract the given parameters.
-    sim_params_from(u, params);
+// Stop here if cancelled (the optimiser has no other way out).
+static void sim_check_cancel(const simUser* u) {
+    if (u->progress != NULL)
+        assert(!__atomic_load_n(&u->progress->cancel, __ATOMIC_ACQUIRE),
+                "execution cancelled");
+}
 
-    // Simulate and evaluate.
-    simState* s = u->s;
-    sim_ulate(s, NO_FULL_OUTPUT);
+// Evaluates the simulated engine `s`.
+static f64 sim_cost_of(const simState* rstr s) {
     f64 cost = 0.0;
     cost += 1e2*sqed(s->Thrust - s->target_Thrust); // thrust target.
     cost -= sqed(s->Isp); // higher Isp = goated.
@@ -491,11 +768,58 @@ static f64 sim_cost(const f64* rstr params, void* rstr user) {
     return cost;
 }
 
-static void sim_optimise(simState* rstr s) {
+static f64 sim_cost(const f64* rstr params, void* rstr user) {
+    simUser* u = user;
+    sim_check_cancel(u);
+
+    // Extract the given parameters.
+    sim_params_from(u, params);
+
+    // Simulate and evaluate.
+    sim_ulate(u->s, u->pool, NO_FULL_OUTPUT);
+    f64 cost = sim_cost_of(u->s);
+
+    if (u->progress != NULL)
+        sim_publish_progress(u->progress, cost);
+    return cost;
+}
+
+static_assert(OPT_BATCH <= SIM_LANES);
+
+// As `sim_cost`, but simulating the candidates together as lanes.
+static void sim_costs(i32 n, const f64* const* params, void* rstr user,
+        f64* rstr costs) {
+    simUser* u = user;
+    sim_check_cancel(u);
+
+    // Each candidate gets its own copy of the state.
+    simState states[OPT_BATCH];
+    simState* lanes[OPT_BATCH] = {0};
+    for (i32 k=0; k<n; ++k) {
+        states[k] = *u->s;
+        lanes[k] = &states[k];
+        simUser lane = *u;
+        lane.s = lanes[k];
+        sim_params_from(&lane, params[k]);
+    }
+
+    sim_ulate_lanes(lanes, n, NO_FULL_OUTPUT);
+    for (i32 k=0; k<n; ++k) {
+        costs[k] = sim_cost_of(lanes[k]);
+        if (u->progress != NULL)
+            sim_publish_progress(u->progress, costs[k]);
+    }
+
+    // Leave the state as if the last candidate was the most recent call.
+    *u->s = states[n - 1];
+}
+
+static void sim_optimise(simState* rstr s, thermalPool* pool,
+        c_Progress* progress) {
     assert(s->target_Thrust > 0.0, "invalid input: target_Thrust=%g",
             s->target_Thrust);
 
-    simUser* u = &(simUser){ .s = s };
+    simUser* u = &(simUser){ .s = s, .progress = progress, .pool = pool };
 
     // Setup the parameter mapping (to facilitate non-full optimisations).
     {
@@ -529,12 +853,14 @@ static void sim_optimise(simState* rstr s) {
     // Grab initial cost for funsies.
     f64 initial_cost = sim_cost(params, u);
 
-    // Run the minimiser.
+    // Run the minimiser. Its independent candidates are simulated together,
+    // unless the march is threaded (which is only used one engine at a time).
+    opt_costs_f* costs = (pool == NULL) ? sim_costs : NULL;
     f64 best_cost;
     u8 tmp[OPT_RUN_MEMSIZE(PARAM_COUNT)]; // worst-case sizing.
     enum { OPTIM_RUNS = 3 }; // several tries for max extraction?
     for (i32 i=0; i<OPTIM_RUNS; ++i) {
-        i32 res = opt_run(sim_cost, u, u->N, tmp, 1e-6, 1e-6, params,
+        i32 res = opt_run(sim_cost, costs, u, u->N, tmp, 1e-6, 1e-6, params,
                 &best_cost);
         if (!res) {
             printf("failed to optimise :((\n");
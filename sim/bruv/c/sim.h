@@ -2,6 +2,7 @@
 #include "br.h"
 
 #include "../bridge/bridge.h"
+#include "profile.h"
 
 
 // Canonical interpretation of the state array.
@@ -33,8 +34,12 @@
     X(wi_chnl, f64, C_OUTPUT)                                   \
     X(psi_chnl, f64, C_OUTPUT)                                  \
     X(eps_chnl, f64, C_INPUT)                                   \
+    X(friction, i64, C_INPUT)                                   \
     X(Pr_fu, f64, C_INPUT)                                      \
     X(T_fu0, f64, C_INPUT)                                      \
+    X(coolant, i64, C_INPUT)                                    \
+    X(thermal_threads, i64, C_INPUT)                            \
+    X(fused_stress, i64, C_INPUT)                               \
     X(P_fu0, f64, C_OUTPUT)                                     \
     X(T_fu1, f64, C_OUTPUT)                                     \
     X(P_fu1, f64, C_OUTPUT)                                     \
@@ -111,6 +116,38 @@
     X(optimise_th_ow, i64, C_INPUT)                             \
     X(optimise_th_chnl, i64, C_INPUT)                           \
     X(optimise_prop_chnl, i64, C_INPUT)                         \
+                                                                \
+    PROFILE_ZONES(SIM_PROFILE_FIELDS_)                          \
+    PROFILE_COUNTS(SIM_COUNT_FIELDS_)                           \
+
+// Zone profiler results, three per zone (see "profile.h"). Always present (so
+// the interpretation is the same either way), but all zero unless compiled with
+// `SIM_PROFILE`.
+#define SIM_PROFILE_FIELDS_(zone)                               \
+    X(prof_##zone##_time, f64, C_OUTPUT)                        \
+    X(prof_##zone##_hits, i64, C_OUTPUT)                        \
+    X(prof_##zone##_iters, i64, C_OUTPUT)                       \
+
+// Operation counts (see "profile.h"), always given.
+#define SIM_COUNT_FIELDS_(name, merge)                          \
+    X(count_##name, i64, C_OUTPUT)                              \
+
+
+// Options for `coolant` (which is also the fuel).
+enum {
+    COOLANT_IPA = 0,
+    COOLANT_ETHANOL = 1,
+    COOLANT_COUNT
+};
+
+// Options for `friction`, the coolant channel friction factor correlation. The
+// explicit ones approximate colebrook without iterating.
+enum {
+    FRICTION_COLEBROOK = 0,
+    FRICTION_SERGHIDES = 1,
+    FRICTION_GOUDAR_SONNAD = 2,
+    FRICTION_COUNT
+};
 
 
 // Da state array.
@@ -126,3 +163,16 @@ c_IH sim_interpretation_hash(void);
 // Simulation entrypoint. Errors are handled via asserts, caller is required to
 // setup assertion failed handling.
 void sim_execute(simState* rstr s);
+
+// Equivalent to `sim_execute`, but publishing the optimiser's progress to
+// `progress` after every cost evaluation and failing (via assert) between
+// evaluations once it has been cancelled. A null `progress` is unwatched.
+void sim_execute_watched(simState* rstr s, c_Progress* progress);
+
+// Executes up to `SIM_LANES` engines, equivalent to `sim_execute` on each but
+// with their coolant marches done in lockstep (with the wall solves of each
+// station vectorised across the engines). The profile and counts are of the
+// whole batch, given to every engine. Errors are handled via asserts, and fail
+// every engine.
+#define SIM_LANES (4)
+void sim_execute_lanes(simState* const* s, i32 count);
@@ -4,115 +4,180 @@
 #include "cea.h"
 #include "maths.h"
 #include "material.h"
+#include "profile.h"
 #include "relations.h"
 
 
+// Column-wise inputs of four stations.
+typedef struct stressLanes_ {
+    dvec4 r;
+    dvec4 th_iw;
+    dvec4 th_chnl;
+    dvec4 wi_chnl;
+    dvec4 wi_web;
+    dvec4 P_g;
+    dvec4 P_c;
+    dvec4 T_wg;
+    dvec4 T_wc;
+} stressLanes_;
+
+// Evaluates the stresses of four stations at once, storing the first `count`
+// into `stns`. Straight-line, so every lane is the same arithmetic as a single
+// station. Returns the firing safety factors.
+static ALWAYSINLINE dvec4 stress_lanes_(const simState* s,
+        const stressLanes_* in, stressStation* stns, i32 count) {
+    dvec4 th_iw = in->th_iw;
+    dvec4 th_ow = dvec4(s->th_ow);
+    dvec4 th_chnl = in->th_chnl;
+    dvec4 wi_chnl = in->wi_chnl;
+    dvec4 wi_web = in->wi_web;
+    dvec4 P_g = in->P_g;
+    dvec4 P_c = in->P_c;
+    dvec4 T_wg = in->T_wg;
+    dvec4 T_wc = in->T_wc;
+
+
+    // Firstly do start-up with only coolant pressure (assume pressure drop
+    // calcs are mostly the same).
+    dvec4 startup_Ys = CuCr1Zr_Ys_dvec4(dvec4(20.0 + 273.15));
+    dvec4 startup_sigma = 0.5*P_c*sqed(wi_chnl/th_iw);
+    dvec4 startup_SF = startup_Ys / startup_sigma;
+
+    dvec4 th_eff = th_iw + th_ow + wi_web*th_chnl/(wi_web + wi_chnl);
+    dvec4 Ys = CuCr1Zr_Ys_dvec4(T_wg);
+    dvec4 E = CuCr1Zr_E_dvec4(T_wg);
+    dvec4 pois = CuCr1Zr_pois_dvec4(T_wg);
+    dvec4 alpha = CuCr1Zr_alpha_dvec4(T_wg);
+
+    dvec4 sigmah_pressure = P_g*in->r/th_eff;
+    dvec4 sigmah_thermal = E*alpha*(T_wg - T_wc)*0.5/(1.0 - pois);
+    dvec4 sigmah_bending = 0.5*(P_c - P_g)*sqed(wi_chnl/th_iw);
+    dvec4 sigmah = sigmah_bending + sigmah_thermal + sigmah_pressure;
+    dvec4 sigmam = E*alpha*(T_wg - T_wc);
+    dvec4 sigma_vm = sqrt(sqed(sigmah) + sqed(sigmam) - sigmah*sigmam);
+    dvec4 SF = Ys / sigma_vm;
+
+    for (i32 k=0; k<count; ++k) {
+        stns[k].startup.sigma = startup_sigma[k];
+        stns[k].startup.Ys = startup_Ys[k];
+        stns[k].startup.SF = startup_SF[k];
+        stns[k].firing.sigmah_pressure = sigmah_pressure[k];
+        stns[k].firing.sigmah_thermal = sigmah_thermal[k];
+        stns[k].firing.sigmah_bending = sigmah_bending[k];
+        stns[k].firing.sigmah = sigmah[k];
+        stns[k].firing.sigmam = sigmam[k];
+        stns[k].firing.sigma_vm = sigma_vm[k];
+        stns[k].firing.Ys = Ys[k];
+        stns[k].firing.SF = SF[k];
+    }
+    return SF;
+}
+
+void stress_station(const simState* s, const ContourSampler* smp, i32 i,
+        f64 P_g, const thermalStation* thermal_stn, stressStation* stn) {
+    stressLanes_* in = &(stressLanes_){
+        .r = dvec4(smp->r[i]),
+        .th_iw = dvec4(smp->th_iw[i]),
+        .th_chnl = dvec4(smp->th_chnl[i]),
+        .wi_chnl = dvec4(smp->wi_chnl[i]),
+        .wi_web = dvec4(smp->wi_web[i]),
+        .P_g = dvec4(P_g),
+        .P_c = dvec4(thermal_stn->P_c),
+        .T_wg = dvec4(thermal_stn->T_wg),
+        .T_wc = dvec4(thermal_stn->T_wc),
+    };
+    stress_lanes_(s, in, stn, 1);
+    PROFILE_ITERS(PROFILE_stress, 1);
+}
+
 void stress_sim(const simState* s, const Contour* cnt,
-        const thermalStation* thermal_stns, i32 thermal_N, stressStation* stns,
-        i32 N) {
+        const ContourSampler* smp, const ContourSampler* thermal_smp,
+        const thermalStation* thermal_stns, stressStation* stns) {
+    i32 N = smp->N;
+    PROFILE_ITERS(PROFILE_stress, N);
 
     ceaFit* fit_gamma = &(ceaFit){0};
-    cea_fit_gamma(fit_gamma, s->P0_cc, s->ofr, s->M_exit);
+    cea_fit_gamma(fit_gamma, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
 
+    // The gas and thermal states aren't vectorisable (iterative and a search,
+    // respectively), so they're gathered into columns first.
+    f64* cols = malloc(4*N * sizeof(f64));
+    assert(cols, "failed to allocate stress columns");
+    f64* P_g = cols;
+    f64* P_c = cols + N;
+    f64* T_wg = cols + 2*N;
+    f64* T_wc = cols + 3*N;
     for (i32 i=0; i<N; ++i) {
-        f64 z = cnt->z_exit * (i/(f64)(N - 1));
-        f64 r = cnt_r(cnt, z);
-
-        f64 drdz;
-        f64 d2rdz; {
-            // A B C D E
-            //     ^ we r here smile.
-            if (i == 0) {
-                // Forward difference at the start.
-                f64 zD = cnt->z_exit * ((i + 1)/(f64)(N - 1));
-                f64 zE = cnt->z_exit * ((i + 2)/(f64)(N - 1));
-                f64 rD = cnt_r(cnt, zD);
-                f64 rE = cnt_r(cnt, zE);
-                drdz = (rD - r) / (zD - z);
-                d2rdz = (rE - 2.0*rD + r) / (zE - zD) / (zD - z);
-            } else if (i == N - 1) {
-                // Backward difference at the end.
-                f64 zB = cnt->z_exit * ((i - 1)/(f64)(N - 1));
-                f64 zA = cnt->z_exit * ((i - 2)/(f64)(N - 1));
-                f64 rB = cnt_r(cnt, zB);
-                f64 rA = cnt_r(cnt, zA);
-                drdz = (r - rB) / (z - zB);
-                d2rdz = (r - 2.0*rB + rA) / (z - zB) / (zB - zA);
-            } else {
-                // Central difference for the rest.
-                f64 zB = cnt->z_exit * ((i - 1)/(f64)(N - 1));
-                f64 zD = cnt->z_exit * ((i + 1)/(f64)(N - 1));
-                f64 rB = cnt_r(cnt, zB);
-                f64 rD = cnt_r(cnt, zD);
-                drdz = (rD - rB) / (zD - zB);
-                d2rdz = (rD - 2.0*r + rB) / (zD - z) / (z - zB);
-            }
-        }
-        // goated.
-        f64 Rm = r;
-        f64 Rh = (nearzero(d2rdz)) ? INF
-               : cbed(sqrt(1.0 + sqed(drdz))) / abs(d2rdz);
-        (void)Rm;
-        (void)Rh;
+        f64 z = smp->z[i];
+        f64 r = smp->r[i];
 
         SpecificHeatRatio* shr_g = &(SpecificHeatRatio){0};
         f64 M_g;
         isentropic_shr_M(shr_g, &M_g, z < cnt->z_tht, sqed(r/cnt->R_tht),
                 fit_gamma, s->gamma_tht /* good guess */);
-        f64 P_g = s->P0_cc * isentropic_P_on_P0(M_g, shr_g);
-
-        f64 P_c;
-        f64 T_wg;
-        f64 T_wc; {
-            f64 t = z / cnt->z_exit;
-            t *= thermal_N - 1;
-            i32 k = min(max((i32)t, 0), thermal_N - 2);
-            t -= k;
-            P_c = lerp(thermal_stns[k].P_c, thermal_stns[k + 1].P_c, t);
-            T_wg = lerp(thermal_stns[k].T_wg, thermal_stns[k + 1].T_wg, t);
-            T_wc = lerp(thermal_stns[k].T_wc, thermal_stns[k + 1].T_wc, t);
-        }
+        P_g[i] = s->P0_cc * isentropic_P_on_P0(M_g, shr_g);
 
-        f64 th_iw = cnt_th_iw(cnt, z);
-        f64 th_ow = s->th_ow;
-        f64 th_chnl = cnt_th_chnl(cnt, z);
-        f64 wi_chnl = cnt_wi_chnl(cnt, z);
-        f64 wi_web = cnt_wi_web(cnt, z);
+        f64 t;
+        i32 k = cnt_sampler_find(thermal_smp, z, &t);
+        P_c[i] = lerp(thermal_stns[k].P_c, thermal_stns[k + 1].P_c, t);
+        T_wg[i] = lerp(thermal_stns[k].T_wg, thermal_stns[k + 1].T_wg, t);
+        T_wc[i] = lerp(thermal_stns[k].T_wc, thermal_stns[k + 1].T_wc, t);
+    }
 
+    for (i32 i=0; i<N; i += 4) {
+        // Pad the final partial block with its last station.
+        i32 count = min(N - i, 4);
+        i32 idx[4];
+        for (i32 k=0; k<4; ++k)
+            idx[k] = i + min(k, count - 1);
+        #define GATHER(x) ( (count == 4)                                    \
+                ? dvec4_from_array((x) + i)                                 \
+                : dvec4((x)[idx[0]], (x)[idx[1]], (x)[idx[2]], (x)[idx[3]]) )
+        stressLanes_* in = &(stressLanes_){
+            .r = GATHER(smp->r),
+            .th_iw = GATHER(smp->th_iw),
+            .th_chnl = GATHER(smp->th_chnl),
+            .wi_chnl = GATHER(smp->wi_chnl),
+            .wi_web = GATHER(smp->wi_web),
+            .P_g = GATHER(P_g),
+            .P_c = GATHER(P_c),
+            .T_wg = GATHER(T_wg),
+            .T_wc = GATHER(T_wc),
+        };
+        #undef GATHER
+        stress_lanes_(s, in, stns + i, count);
+    }
 
-        // Firstly do start-up with only coolant pressure (assume pressure drop
-        // calcs are mostly the same).
-        {
-            f64 T = 20.0 + 273.15;
-            f64 Ys = CuCr1Zr_Ys(T);
+    free(cols);
+}
 
-            stns[i].startup.sigma = 0.5*P_c*sqed(wi_chnl/th_iw);
-            stns[i].startup.Ys = Ys;
-            stns[i].startup.SF = Ys / stns[i].startup.sigma;
+i32 stress_min_SF(const stressStation* stns, i32 N) {
+    // Running minimum per lane, over stations `i + lane`.
+    dvec4 best = dv4INF;
+    i64x4 best_i = {0, 0, 0, 0};
+    i32 i = 0;
+    for (; i + 4 <= N; i += 4) {
+        dvec4 SF = dvec4(stns[i].firing.SF, stns[i + 1].firing.SF,
+                stns[i + 2].firing.SF, stns[i + 3].firing.SF);
+        i64x4 lt = (SF < best);
+        best = min(SF, best);
+        best_i = (best_i & ~lt) | ((i64x4){i, i + 1, i + 2, i + 3} & lt);
+    }
+    // Reduce lanes, taking the earliest station on ties (as a serial scan
+    // would).
+    i32 k = (i32)best_i[0];
+    f64 k_SF = best[0];
+    for (i32 j=1; j<4; ++j) {
+        if (best[j] < k_SF || (best[j] == k_SF && best_i[j] < k)) {
+            k = (i32)best_i[j];
+            k_SF = best[j];
         }
-
-        {
-            f64 th_eff = th_iw + th_ow + wi_web*th_chnl/(wi_web + wi_chnl);
-            f64 Ys = CuCr1Zr_Ys(T_wg);
-            f64 E = CuCr1Zr_E(T_wg);
-            f64 pois = CuCr1Zr_pois(T_wg);
-            f64 alpha = CuCr1Zr_alpha(T_wg);
-
-            f64 sigmah_pressure = P_g*r/th_eff;
-            f64 sigmah_thermal = E*alpha*(T_wg - T_wc)*0.5/(1.0 - pois);
-            f64 sigmah_bending = 0.5*(P_c - P_g)*sqed(wi_chnl/th_iw);
-            f64 sigmah = sigmah_bending + sigmah_thermal + sigmah_pressure;
-            f64 sigmam = E*alpha*(T_wg - T_wc);
-
-            stns[i].firing.sigmah_pressure = sigmah_pressure;
-            stns[i].firing.sigmah_thermal = sigmah_thermal;
-            stns[i].firing.sigmah_bending = sigmah_bending;
-            stns[i].firing.sigmah = sigmah;
-            stns[i].firing.sigmam = sigmam;
-            stns[i].firing.sigma_vm = sqrt(sqed(sigmah) + sqed(sigmam)
-                                         - sigmah*sigmam);
-            stns[i].firing.Ys = Ys;
-            stns[i].firing.SF = Ys / stns[i].firing.sigma_vm;
+    }
+    for (; i<N; ++i) {
+        if (stns[i].firing.SF < k_SF) {
+            k = i;
+            k_SF = stns[i].firing.SF;
         }
     }
+    return k;
 }
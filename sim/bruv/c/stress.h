@@ -6,7 +6,7 @@
 #include "thermal.h"
 
 
-typedef struct stressStation {
+struct stressStation {
     struct {
         f64 sigma;
         f64 Ys;
@@ -22,8 +22,20 @@ typedef struct stressStation {
         f64 Ys;
         f64 SF;
     } firing;
-} stressStation;
+};
 
+// Evaluates the wall stresses at station `i` of `smp`, given the gas pressure
+// and final thermal solution there.
+void stress_station(const simState* s, const ContourSampler* smp, i32 i,
+        f64 P_g, const thermalStation* thermal_stn, stressStation* stn);
+
+// Evaluates the wall stresses at the stations of `smp`, filling `stns` (which
+// must have `smp->N` entries). The thermal results are interpolated from their
+// own stations, `thermal_smp`.
 void stress_sim(const simState* s, const Contour* cnt,
-        const thermalStation* thermal_stns, i32 thermal_N, stressStation* stns,
-        i32 N);
+        const ContourSampler* smp, const ContourSampler* thermal_smp,
+        const thermalStation* thermal_stns, stressStation* stns);
+
+// Returns the index of the station with the smallest firing safety factor (the
+// first, if tied).
+i32 stress_min_SF(const stressStation* stns, i32 N);
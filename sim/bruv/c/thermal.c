@@ -1,320 +1,1129 @@
 #include "thermal.h"
 
+#include <pthread.h>
+
 #include "assertion.h"
 #include "cea.h"
 #include "ethanol.h"
 #include "ipa.h"
 #include "maths.h"
 #include "material.h"
+#include "profile.h"
 #include "relations.h"
+#include "stress.h"
 
 
-i32 thermal_sim(const simState* s, const Contour* cnt, thermalStation* stns,
-        i32 N) {
-    #define throw() return 0;
+// Every specialisation of the marches, by coolant and friction factor. Their
+// bodies are always inlined with these as constants, so each instance calls
+// its property approximations and friction correlation directly, and the
+// choice is dispatched once per march rather than per station.
+#define THERMAL_SPECIALISATIONS(Z)                                          \
+    Z(ipa_colebrook, COOLANT_IPA, FRICTION_COLEBROOK)                       \
+    Z(ipa_serghides, COOLANT_IPA, FRICTION_SERGHIDES)                       \
+    Z(ipa_goudar_sonnad, COOLANT_IPA, FRICTION_GOUDAR_SONNAD)               \
+    Z(ethanol_colebrook, COOLANT_ETHANOL, FRICTION_COLEBROOK)               \
+    Z(ethanol_serghides, COOLANT_ETHANOL, FRICTION_SERGHIDES)               \
+    Z(ethanol_goudar_sonnad, COOLANT_ETHANOL, FRICTION_GOUDAR_SONNAD)       \
 
-    i32 possible_system = 1;
+// Clamps the given coolant state into its property approximations, returning
+// non-zero if it already was. Note the approximations are chosen by pasting the
+// coolant prefix, so when `coolant` is a constant this folds to direct calls.
+static ALWAYSINLINE i32 coolant_clamp_(i64 coolant, f64* rstr T,
+        f64* rstr P) {
+    #define COOLANT_CLAMP(prefix, PREFIX) do {                               \
+            f64 P_ = min(max(*P, 1.001*PREFIX##_MIN_P),                      \
+                    0.999*PREFIX##_MAX_P);                                   \
+            f64 T_ = min(max(*T, 1.001*PREFIX##_MIN_T),                      \
+                    0.999*prefix##_max_T(P_));                               \
+            i32 within = (P_ == *P) && (T_ == *T);                           \
+            *P = P_;                                                         \
+            *T = T_;                                                         \
+            return within;                                                   \
+        } while (0)
+    if (coolant == COOLANT_ETHANOL)
+        COOLANT_CLAMP(ethanol, ETHANOL);
+    COOLANT_CLAMP(ipa, IPA);
+    #undef COOLANT_CLAMP
+}
+
+// Evaluates the properties of the given coolant, returning non-zero if the
+// state is within the approximations (otherwise it is clamped into them).
+static ALWAYSINLINE i32 coolant_properties_(i64 coolant, f64 T, f64 P,
+        f64* rstr rho, f64* rstr cp, f64* rstr mu, f64* rstr k) {
+    i32 within = coolant_clamp_(coolant, &T, &P);
+    if (coolant == COOLANT_ETHANOL) {
+        *rho = ethanol_rho(T, P);
+        *cp = ethanol_cp(T, P);
+        *mu = ethanol_mu(T, P);
+        *k = ethanol_k(T, P);
+    } else {
+        *rho = ipa_rho(T, P);
+        *cp = ipa_cp(T, P);
+        *mu = ipa_mu(T, P);
+        *k = ipa_k(T, P);
+    }
+    return within;
+}
 
+// Batch `coolant_properties_` over `N` states, through the tables' batch
+// lookups. `T` and `P` are clamped in-place (so a state was within the
+// approximations iff it is unchanged).
+static ALWAYSINLINE void coolant_properties_many_(i64 coolant, i64 N,
+        f64* rstr T, f64* rstr P, f64* rstr rho, f64* rstr cp, f64* rstr mu,
+        f64* rstr k) {
+    for (i64 i=0; i<N; ++i)
+        coolant_clamp_(coolant, &T[i], &P[i]);
+    i64 oob = (coolant == COOLANT_ETHANOL)
+            ? ethanol_props_many(N, T, P, rho, cp, mu, k, NULL)
+            : ipa_props_many(N, T, P, rho, cp, mu, k, NULL);
+    assert(oob == 0, "approximation input oob: %lld coolant states", oob);
+}
+
+// Film cooling constants of a coolant, at its film temperature.
+typedef struct coolantFilm_ {
+    f64 T;
+    f64 cpl; // liquid specific heat.
+    f64 Hvap; // heat of vaporisation.
+    f64 cpv; // vapour specific heat.
+} coolantFilm_;
+
+// Returns the film constants of the given coolant, chosen as in
+// `coolant_properties_`. Ethanol's are taken at the same saturation pressure
+// as ipa's (~2.1MPa), scaling ipa's by the ratio of the tabulated liquid cp,
+// Watson's relation for the heat of vaporisation and the ideal gas vapour cp.
+static ALWAYSINLINE coolantFilm_ coolant_film_(i64 coolant) {
+    if (coolant == COOLANT_ETHANOL) {
+        return (coolantFilm_){
+            .T    = 444.6,
+            .cpl  = 3625.226103826865,
+            .Hvap = 215838.7996949162,
+            .cpv  = 2183.184142002486,
+        };
+    }
+    return (coolantFilm_){
+        .T    = 450.0,
+        .cpl  = 3860.527052563261,
+        .Hvap = 164045.7251946664,
+        .cpv  = 2334.731417515824,
+    };
+}
+
+void thermal_bartz_init(thermalBartz* bartz, const simState* s) {
     ceaFit* fit_gamma = &(ceaFit){0};
     ceaFit* fit_cp = &(ceaFit){0};
     ceaFit* fit_mu = &(ceaFit){0};
     ceaFit* fit_Pr = &(ceaFit){0};
-    cea_fit_gamma(fit_gamma, s->P0_cc, s->ofr, s->M_exit);
-    cea_fit_cp(fit_cp, s->P0_cc, s->ofr, s->M_exit);
-    cea_fit_mu(fit_mu, s->P0_cc, s->ofr, s->M_exit);
-    cea_fit_Pr(fit_Pr, s->P0_cc, s->ofr, s->M_exit);
+    cea_fit_gamma(fit_gamma, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_cp(fit_cp, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_mu(fit_mu, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_Pr(fit_Pr, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
 
+    // `T/T0 = 1/(1 + (gamma - 1)/2 M^2) = 1/(1 + u^2)`.
     SpecificHeatRatio* shr_exit = get_shr(s->gamma_exit);
+    f64 min_T_on_T0 = isentropic_T_on_T0(s->M_exit, shr_exit);
+    bartz->u_sonic = sqrt(0.5*(cea_sample(fit_gamma, 1.0) - 1.0));
+    bartz->u_exit = sqrt(1.0/min_T_on_T0 - 1.0);
+    assert(bartz->u_sonic < bartz->u_exit, "subsonic exit? u_sonic=%g, "
+            "u_exit=%g", bartz->u_sonic, bartz->u_exit);
 
-    f64 ell = 0.0;
-    for (i32 i=0; i<1000; ++i) {
-        f64 zA = cnt->z_exit * (i/(f64)(1000));
-        f64 zB = cnt->z_exit * ((i + 1)/(f64)(1000));
-        f64 rA = cnt_r(cnt, zA);
-        f64 rB = cnt_r(cnt, zB);
-        ell += hypot(rB - rA, zB - zA);
+    for (i32 j=0; j<2; ++j) {
+        f64 u_lo = (j == 0) ? 0.0 : bartz->u_sonic;
+        f64 u_hi = (j == 0) ? bartz->u_sonic : bartz->u_exit;
+        for (i32 i=0; i<THERMAL_BARTZ_N; ++i) {
+            f64 u = lerpidx(u_lo, u_hi, i, THERMAL_BARTZ_N);
+            f64 M_gw = mach_for_temperature(1.0/(1.0 + sqed(u)), fit_gamma);
+            assert(M_gw >= 0.0, "nonphysical property: M_gw=%g", M_gw);
+            f64 gamma_g = cea_sample(fit_gamma, M_gw);
+            f64 cp_g = cea_sample(fit_cp, M_gw);
+            f64 mu_g = cea_sample(fit_mu, M_gw);
+            f64 Pr_g = cea_sample(fit_Pr, M_gw);
+            assert(mu_g > 0.0, "nonphysical property, bartz_mu_g: %g", mu_g);
+            assert(cp_g > 0.0, "nonphysical property, bartz_cp_g: %g", cp_g);
+            assert(Pr_g > 0.0, "nonphysical property, bartz_Pr_g: %g", Pr_g);
+            bartz->gamma[j][i] = gamma_g;
+            bartz->group[j][i] = pow(mu_g, 0.2) * cp_g * pow(Pr_g, -0.6);
+        }
     }
+}
+
+// Linearly interpolates the bartz tables at the given `u` (clamped into range).
+static void thermal_bartz_sample_(const thermalBartz* bartz, f64 u,
+        f64* rstr gamma, f64* rstr group) {
+    u = min(max(u, 0.0), bartz->u_exit);
+    i32 j = (u >= bartz->u_sonic);
+    f64 u_lo = (j == 0) ? 0.0 : bartz->u_sonic;
+    f64 u_hi = (j == 0) ? bartz->u_sonic : bartz->u_exit;
+    f64 t = invlerp(u_lo, u_hi, u) * (THERMAL_BARTZ_N - 1);
+    i32 i = min(max((i32)t, 0), THERMAL_BARTZ_N - 2);
+    t -= i;
+    *gamma = lerp(bartz->gamma[j][i], bartz->gamma[j][i + 1], t);
+    *group = lerp(bartz->group[j][i], bartz->group[j][i + 1], t);
+}
+
+// Everything about a station which doesn't depend on the coolant state.
+typedef struct thermalGas_ {
+    f64 M_g;
+    f64 T_g;
+    f64 P_g;
+    f64 adiabatic_T_wg;
+    f64 filmcooled_T_wg;
+    f64 bartz_station; // bartz terms independant of wall temperature.
+    f64 Rth_iw;
+    f64 Rth_pdms;
+    f64 A_c;
+    f64 HD_c;
+} thermalGas_;
+
+static void thermal_gas_(const simState* s, const Contour* cnt,
+        const ContourSampler* smp, const ceaFit* fit_gamma,
+        const ceaFit* fit_cp, const ceaFit* fit_mu, const ceaFit* fit_Pr,
+        const coolantFilm_* film, i32 i, thermalGas_* rstr gas) {
+    f64 zA = smp->z[i];
+    f64 rA = smp->r[i];
+    f64 ell = smp->ell[i];
 
     // Film cooling parameters.
-    f64 T_film = 450.0;
-    f64 cpl_film  = 3860.527052563261;
-    f64 Hvap_film = 164045.7251946664;
-    f64 cpv_film  = 2334.731417515824;
-
-    stns[N - 1] = (thermalStation){
-        .T_c = s->T_fu0,
-        .P_c = s->P_fu0,
+    f64 T_film = film->T;
+    f64 cpl_film  = film->cpl;
+    f64 Hvap_film = film->Hvap;
+    f64 cpv_film  = film->cpv;
+
+    // Combustion gas properties:
+    f64 dm_g = s->dm_cc;
+    f64 A_g = PI*sqed(rA);
+    SpecificHeatRatio* shr_g = &(SpecificHeatRatio){0};
+    f64 M_g;
+    isentropic_shr_M(shr_g, &M_g, zA < cnt->z_tht, A_g/s->A_tht, fit_gamma,
+            s->gamma_tht /* good guess */);
+    f64 y1M22_g = get_y1M22(M_g, shr_g);
+    f64 T_g = s->T0_cc * isentropicx_T_on_T0(y1M22_g, shr_g);
+    f64 P_g = s->P0_cc * isentropicx_P_on_P0(y1M22_g, shr_g);
+    f64 cp_g = cea_sample(fit_cp, M_g);
+    f64 mu_g = cea_sample(fit_mu, M_g);
+    f64 Pr_g = cea_sample(fit_Pr, M_g);
+    assert(cp_g > 0.0, "nonphysical property, cp_g: %g", cp_g);
+    assert(mu_g > 0.0, "nonphysical property, mu_g: %g", mu_g);
+    assert(Pr_g > 0.0, "nonphysical property, Pr_g: %g", Pr_g);
+    f64 cbrt_Pr_g = cbrt(Pr_g);
+
+    // Adiabatic wall temperature.
+    f64 adiabatic_T_wg = T_g * (1.0 + cbrt_Pr_g*y1M22_g);
+
+    f64 filmcooled_T_wg; {
+        f64 T = adiabatic_T_wg;
+
+        f64 eta_c = 0.25;
+        f64 f_friction = 0.035;
+        f64 Vg_Vd = 1.2;
+        f64 A_coeff = 0.37;
+        f64 a = 2.0 * Vg_Vd / f_friction;
+        f64 b = Vg_Vd - 1.0;
+        f64 dm_film = s->prop_fc * s->dm_fu;
+        f64 GcGg = dm_film / (dm_film + dm_g);
+        f64 protected_T; {
+            f64 b_term  = pow(b, cpv_film/cp_g);
+            f64 H_avail = GcGg * eta_c * a * (1.0 + b_term);
+            protected_T = (cpv_film * T
+                            + H_avail * (cpl_film * T_film - Hvap_film))
+                        / (cpv_film + H_avail * cpl_film);
+        }
+        f64 eta; {
+            eta = min(max((T - protected_T) / (T - T_film), 0.0), 1.0);
+            eta = min(max(eta, 0.0), 1.0);
+            f64 B = (dm_g * cp_g) / (dm_film * cpl_film);
+            f64 gl_part = 1.0 + A_coeff*B*ell / 2.0/s->R_cc;
+            eta = lerp(eta, 1.0, 1.0/gl_part);
+            eta = min(max(eta, 0.0), 1.0);
+        }
+        filmcooled_T_wg = lerp(T, T_film, eta);
+    }
+
+    // Bartz terms which are independant of wall temperature.
+    f64 bartz_station; {
+        // upstream curvature?
+        f64 Rcurvature_tht = 1.5*cnt->R_tht;
+        bartz_station = 0.026
+                      * pow(dm_g/s->A_tht, 0.8)
+                      * pow(0.5/Rcurvature_tht/cnt->R_tht, 0.1)
+                      * pow(s->A_tht/A_g, 0.9);
+    }
+
+    // Cylindrical conductor resistance.
+    f64 k_iw = CuCr1Zr_k();
+    f64 Rth_iw = rA * LN2*log2(1.0 + smp->th_iw[i]/rA) / k_iw;
+    f64 Rth_pdms = rA * LN2*log2(1.0 + s->th_pdms/rA) / s->k_pdms;
+
+    f64 th_chnl = smp->th_chnl[i];
+    f64 psi_chnl = smp->psi_chnl[i];
+    *gas = (thermalGas_){
+        .M_g = M_g,
+        .T_g = T_g,
+        .P_g = P_g,
+        .adiabatic_T_wg = adiabatic_T_wg,
+        .filmcooled_T_wg = filmcooled_T_wg,
+        .bartz_station = bartz_station,
+        .Rth_iw = Rth_iw,
+        .Rth_pdms = Rth_pdms,
+        .A_c = psi_chnl*th_chnl // ~approx as rectangle.
+             * s->no_chnl,
+        .HD_c = 2.0*psi_chnl*th_chnl/(psi_chnl + th_chnl),
     };
-    // March from nozzle exit to injector face.
-    for (i32 i=N - 1; i>-1; --i) {
-        f64 zA = cnt->z_exit * (i/(f64)(N - 1));
-        f64 zB = cnt->z_exit * ((i - 1)/(f64)(N - 1));
-        f64 rA = cnt_r(cnt, zA);
-        f64 rB = cnt_r(cnt, zB);
-
-        // Combustion gas properties:
-        f64 dm_g = s->dm_cc;
-        f64 T0_g = s->T0_cc;
-        f64 A_g = PI*sqed(rA);
-        SpecificHeatRatio* shr_g = &(SpecificHeatRatio){0};
-        f64 M_g;
-        isentropic_shr_M(shr_g, &M_g, zA < cnt->z_tht, A_g/s->A_tht, fit_gamma,
-                s->gamma_tht /* good guess */);
-        f64 y1M22_g = get_y1M22(M_g, shr_g);
-        f64 T_g = s->T0_cc * isentropicx_T_on_T0(y1M22_g, shr_g);
-        f64 cp_g = cea_sample(fit_cp, M_g);
-        f64 mu_g = cea_sample(fit_mu, M_g);
-        f64 Pr_g = cea_sample(fit_Pr, M_g);
-        assert(cp_g > 0.0, "nonphysical property, cp_g: %g", cp_g);
-        assert(mu_g > 0.0, "nonphysical property, mu_g: %g", mu_g);
-        assert(Pr_g > 0.0, "nonphysical property, Pr_g: %g", Pr_g);
-        f64 cbrt_Pr_g = cbrt(Pr_g);
-
-        // Coolant properties:
-        f64 T_c = stns[i].T_c;
-        f64 P_c = stns[i].P_c;
-        assert(T_c > 0.0, "nonphysical property, T_c: %g", T_c);
-        assert(P_c > 0.0, "nonphysical property, P_c: %g", P_c);
-        f64 ipa_P_c = min(max(P_c, 1.001*IPA_MIN_P), 0.999*IPA_MAX_P);
-        f64 ipa_T_c = min(max(T_c, 1.001*IPA_MIN_T), 0.999*ipa_max_T(ipa_P_c));
-        possible_system &= (ipa_P_c == P_c) && (ipa_T_c == T_c);
-        f64 th_iw = cnt_th_iw(cnt, zA);
-        f64 th_chnl = cnt_th_chnl(cnt, zA);
-        f64 wi_web = cnt_wi_web(cnt, zA);
-        f64 wi_chnl = cnt_wi_chnl(cnt, zA);
-        f64 psi_chnl = cnt_psi_chnl(cnt, zA);
-        f64 A_c = psi_chnl*th_chnl // ~approx as rectangle.
-                * s->no_chnl;
-        f64 HD_c = 2.0*psi_chnl*th_chnl/(psi_chnl + th_chnl);
-        f64 rho_c = ipa_rho(ipa_T_c, ipa_P_c);
-        f64 cp_c = ipa_cp(ipa_T_c, ipa_P_c);
-        f64 mu_c = ipa_mu(ipa_T_c, ipa_P_c);
-        f64 k_c = ipa_k(ipa_T_c, ipa_P_c);
-        assert(rho_c > 0.0, "nonphysical property, rho_c: %g", rho_c);
-        assert(cp_c > 0.0, "nonphysical property, cp_c: %g", cp_c);
-        assert(mu_c > 0.0, "nonphysical property, mu_c: %g", mu_c);
-        assert(k_c > 0.0, "nonphysical property, k_c: %g", k_c);
-        f64 dm_c = s->dm_fu * (1.0 + s->prop_fc);
-        f64 G_c = dm_c/A_c;
-        f64 vel_c = G_c/rho_c;
-        f64 Re_c = G_c*HD_c/mu_c;
-        f64 Pr_c = cp_c*mu_c/k_c;
-        f64 ff_c = friction_factor_colebrook(Re_c, HD_c, s->eps_chnl);
-        f64 Nu_c = nusselt_dittus_boelter(Re_c, Pr_c, 1);
-        assert(ff_c > 0.0, "nonphysical property, ff_c: %g", ff_c);
-        assert(Nu_c > 0.0, "nonphysical property, Nu_c: %g", Nu_c);
-
-
-        // Adiabatic wall temperature.
-        f64 adiabatic_T_wg = T_g * (1.0 + cbrt_Pr_g*y1M22_g);
-
-        f64 filmcooled_T_wg; {
-            f64 T = adiabatic_T_wg;
-
-            f64 eta_c = 0.25;
-            f64 f_friction = 0.035;
-            f64 Vg_Vd = 1.2;
-            f64 A_coeff = 0.37;
-            f64 a = 2.0 * Vg_Vd / f_friction;
-            f64 b = Vg_Vd - 1.0;
-            f64 dm_film = s->prop_fc * s->dm_fu;
-            f64 GcGg = dm_film / (dm_film + dm_g);
-            f64 protected_T; {
-                f64 b_term  = pow(b, cpv_film/cp_g);
-                f64 H_avail = GcGg * eta_c * a * (1.0 + b_term);
-                protected_T = (cpv_film * T
-                                + H_avail * (cpl_film * T_film - Hvap_film))
-                            / (cpv_film + H_avail * cpl_film);
-            }
-            f64 eta; {
-                eta = min(max((T - protected_T) / (T - T_film), 0.0), 1.0);
-                eta = min(max(eta, 0.0), 1.0);
-                f64 B = (dm_g * cp_g) / (dm_film * cpl_film);
-                f64 gl_part = 1.0 + A_coeff*B*ell / 2.0/s->R_cc;
-                eta = lerp(eta, 1.0, 1.0/gl_part);
-                eta = min(max(eta, 0.0), 1.0);
+}
+
+// Evaluates the coolant side of station `i` given the coolant properties at
+// the coolant state already in `stns[i]`, filling in its properties and
+// (fin-corrected) convection coefficient.
+static ALWAYSINLINE void thermal_coolant_at_(const simState* s,
+        const ContourSampler* smp, const thermalGas_* gas, i32 i,
+        thermalStation* stns, f64 rho_c, f64 cp_c, f64 mu_c, f64 k_c,
+        i64 friction) {
+    f64 th_chnl = smp->th_chnl[i];
+    f64 wi_web = smp->wi_web[i];
+    f64 wi_chnl = smp->wi_chnl[i];
+    f64 A_c = gas->A_c;
+    f64 HD_c = gas->HD_c;
+    assert(rho_c > 0.0, "nonphysical property, rho_c: %g", rho_c);
+    assert(cp_c > 0.0, "nonphysical property, cp_c: %g", cp_c);
+    assert(mu_c > 0.0, "nonphysical property, mu_c: %g", mu_c);
+    assert(k_c > 0.0, "nonphysical property, k_c: %g", k_c);
+    f64 dm_c = s->dm_fu * (1.0 + s->prop_fc);
+    f64 G_c = dm_c/A_c;
+    f64 vel_c = G_c/rho_c;
+    f64 Re_c = G_c*HD_c/mu_c;
+    f64 Pr_c = cp_c*mu_c/k_c;
+    f64 ff_c;
+    switch (friction) {
+        case FRICTION_SERGHIDES:
+            ff_c = friction_factor_serghides(Re_c, HD_c, s->eps_chnl);
+            break;
+        case FRICTION_GOUDAR_SONNAD:
+            ff_c = friction_factor_goudar_sonnad(Re_c, HD_c, s->eps_chnl);
+            break;
+        default:
+            ff_c = friction_factor_colebrook(Re_c, HD_c, s->eps_chnl);
+            break;
+    }
+    f64 Nu_c = nusselt_dittus_boelter(Re_c, Pr_c, 1);
+    assert(ff_c > 0.0, "nonphysical property, ff_c: %g", ff_c);
+    assert(Nu_c > 0.0, "nonphysical property, Nu_c: %g", Nu_c);
+
+    f64 k_web = CuCr1Zr_k();
+
+    // Coolant convection coefficient.
+    f64 h_c = Nu_c*k_c/HD_c;
+
+    // Model web as a fin.
+    f64 eta_web; {
+        f64 term = sqrt(2.0 * h_c * wi_web / k_web) * th_chnl / wi_chnl;
+        f64 exp_twoterm = exp2(LOG2E*2.0*term);
+        f64 tanh_term = (exp_twoterm - 1.0)
+                      / (exp_twoterm + 1.0);
+        eta_web = tanh_term / term;
+    }
+    // Correct for fin.
+    h_c *= (wi_chnl + 2.0*eta_web*th_chnl) / (wi_chnl + wi_web);
+
+    stns[i].h_c = h_c;
+    stns[i].vel_c = vel_c;
+    stns[i].rho_c = rho_c;
+    stns[i].cp_c = cp_c;
+    stns[i].ff_c = ff_c;
+    stns[i].Re_c = Re_c;
+    stns[i].Pr_c = Pr_c;
+    stns[i].T_gw = gas->filmcooled_T_wg;
+}
+
+// Evaluates the coolant side of station `i` at the coolant state already in
+// `stns[i]` (see `thermal_coolant_at_`). Returns non-zero if the coolant state
+// is within the property approximations.
+static ALWAYSINLINE i32 thermal_coolant_(const simState* s,
+        const ContourSampler* smp, const thermalGas_* gas, i32 i,
+        thermalStation* stns, i64 coolant, i64 friction) {
+    f64 T_c = stns[i].T_c;
+    f64 P_c = stns[i].P_c;
+    assert(T_c > 0.0, "nonphysical property, T_c: %g", T_c);
+    assert(P_c > 0.0, "nonphysical property, P_c: %g", P_c);
+    f64 rho_c;
+    f64 cp_c;
+    f64 mu_c;
+    f64 k_c;
+    i32 possible = coolant_properties_(coolant, T_c, P_c, &rho_c, &cp_c, &mu_c,
+            &k_c);
+    thermal_coolant_at_(s, smp, gas, i, stns, rho_c, cp_c, mu_c, k_c,
+            friction);
+    return possible;
+}
+
+// One station's wall heat balance, as solved by `thermal_walls_`.
+typedef struct thermalWall_ {
+    const simState* s;
+    const thermalBartz* bartz;
+    const thermalGas_* gas;
+    thermalStation* stn; // coolant side already evaluated.
+    f64 guess[3]; // initial T_pdms, T_wg, T_wc.
+    f64 prev[3]; // upstream T_pdms, T_wg, T_wc.
+    f64 max_DT; // how far from `prev` the wall may be, zero if unlimited.
+} thermalWall_;
+
+// Solves the wall heat balance of up to four stations at once (one per lane,
+// possibly of different designs), filling in the rest of each station.
+// Iterates from the `guess` wall temperatures, holding them within `max_DT`
+// of `prev`. Every lane is iterated until it alone converges, giving results
+// identical to solving it by itself.
+static void thermal_walls_(const thermalWall_* walls, i32 count) {
+    enum { MAX_ITERS = 300 };
+    // Converged once no temperature moves by more than this [K]. Note where
+    // the iteration ends up depends on where it started by about this much,
+    // so it's kept tight enough that the parallel and serial marches agree.
+    f64 tolerance = 1e-3;
+
+    // Gather each lane's inputs, padding with the first.
+    dvec4 T0_g;
+    dvec4 M_g;
+    dvec4 T_g;
+    dvec4 adiabatic_T_wg;
+    dvec4 filmcooled_T_wg;
+    dvec4 bartz_station;
+    dvec4 Rth_iw;
+    dvec4 Rth_pdms;
+    dvec4 Rth_c;
+    dvec4 T_c;
+    dvec4 T_pdms;
+    dvec4 T_wg;
+    dvec4 T_wc;
+    dvec4 prev_T_pdms;
+    dvec4 prev_T_wg;
+    dvec4 prev_T_wc;
+    dvec4 max_DT;
+    for (i32 k=0; k<4; ++k) {
+        const thermalWall_* w = &walls[(k < count) ? k : 0];
+        T0_g[k] = w->s->T0_cc;
+        M_g[k] = w->gas->M_g;
+        T_g[k] = w->gas->T_g;
+        adiabatic_T_wg[k] = w->gas->adiabatic_T_wg;
+        filmcooled_T_wg[k] = w->gas->filmcooled_T_wg;
+        bartz_station[k] = w->gas->bartz_station;
+        Rth_iw[k] = w->gas->Rth_iw;
+        Rth_pdms[k] = w->gas->Rth_pdms;
+        // Fin + convective resistance.
+        Rth_c[k] = 1.0 / w->stn->h_c;
+        T_c[k] = w->stn->T_c;
+        T_pdms[k] = w->guess[0];
+        T_wg[k] = w->guess[1];
+        T_wc[k] = w->guess[2];
+        prev_T_pdms[k] = w->prev[0];
+        prev_T_wg[k] = w->prev[1];
+        prev_T_wc[k] = w->prev[2];
+        max_DT[k] = w->max_DT;
+    }
+    i64x4 limited = (max_DT > 0.0);
+
+    // Wall heat/temperature numerical search:
+    dvec4 q = dv4NAN;
+    dvec4 h_g = dv4NAN;
+    dvec4 old_T_pdms = T_pdms;
+    dvec4 old_T_wg = T_wg;
+    dvec4 old_T_wc = T_wc;
+
+    i32 active = (1 << count) - 1;
+    for (i32 iter=0; /* true */; ++iter) {
+        T_pdms = max(T_pdms, dvec4(250.0));
+        T_wg = max(T_wg, dvec4(250.0));
+        T_wc = max(T_wc, dvec4(250.0));
+
+        i64x4 possible_rn; {
+            i64x4 within = (T_pdms > prev_T_pdms - max_DT)
+                         & (T_pdms < prev_T_pdms + max_DT)
+                         & (T_wg > prev_T_wg - max_DT)
+                         & (T_wg < prev_T_wg + max_DT)
+                         & (T_wc > prev_T_wc - max_DT)
+                         & (T_wc < prev_T_wc + max_DT);
+            possible_rn = within | ~limited;
+            #define LIMIT(x) do {                                               \
+                    dvec4 lo = prev_##x - max_DT;                               \
+                    dvec4 hi = prev_##x + max_DT;                               \
+                    dvec4 lim = min(max(x, lo), hi);                            \
+                    x = fp_from_bits((fp_bits(lim) & limited)                   \
+                                   | (fp_bits(x) & ~limited));                  \
+                } while (0)
+            LIMIT(T_pdms);
+            LIMIT(T_wg);
+            LIMIT(T_wc);
+            #undef LIMIT
+        }
+
+        dvec4 diff_T_pdms = max(T_pdms - old_T_pdms, old_T_pdms - T_pdms);
+        dvec4 diff_T_wg = max(T_wg - old_T_wg, old_T_wg - T_wg);
+        dvec4 diff_T_wc = max(T_wc - old_T_wc, old_T_wc - T_wc);
+        dvec4 max_diff = max(diff_T_pdms, max(diff_T_wg, diff_T_wc));
+        i64x4 converged = possible_rn & (max_diff < tolerance);
+
+        // Retire the lanes which are done.
+        for (i32 k=0; k<count; ++k) {
+            if (!(active & (1 << k)))
+                continue;
+            if (iter < MAX_ITERS && (iter == 0 || !converged[k]))
+                continue;
+            // Hitting the iteration limit is let slide.
+            thermalStation* stn = walls[k].stn;
+            stn->xtra = iter;
+            COUNT_ADD(wall_iters, iter);
+            COUNT_MAX(wall_iters_max, iter);
+            stn->q = q[k];
+            stn->h_g = h_g[k];
+            stn->T_pdms = T_pdms[k];
+            stn->T_wg = T_wg[k];
+            stn->T_wc = T_wc[k];
+            active &= ~(1 << k);
+        }
+        if (!active)
+            break;
+
+        old_T_pdms = T_pdms;
+        old_T_wg = T_wg;
+        old_T_wc = T_wc;
+
+        // Bartz equation for convection coefficient.
+        {
+            // Use properties evauluated at the eckert temperature.
+            dvec4 T_gw = 0.5*T_pdms + 0.28*T0_g + 0.22*adiabatic_T_wg;
+            // Clamped between the exit temperature and T0 by the lookup.
+            dvec4 bartz_u = sqrt(max(T0_g/T_gw - 1.0, dv4ZERO));
+            dvec4 bartz_gamma_g;
+            dvec4 bartz_group_g;
+            for (i32 k=0; k<4; ++k) {
+                const thermalWall_* w = &walls[(k < count) ? k : 0];
+                f64 gamma;
+                f64 group;
+                thermal_bartz_sample_(w->bartz, bartz_u[k], &gamma, &group);
+                bartz_gamma_g[k] = gamma;
+                bartz_group_g[k] = group;
             }
-            filmcooled_T_wg = lerp(T, T_film, eta);
+            dvec4 bartz_y1M22_g = 0.5*(bartz_gamma_g - 1.0)*sqed(M_g);
+            f64 w = 0.6; // common estimate.
+            h_g = bartz_station
+                * bartz_group_g
+                * pow(0.5*filmcooled_T_wg/T0_g*(1.0 + bartz_y1M22_g) + 0.5,
+                      dvec4(0.2*w - 0.8))
+                * pow(1.0 + bartz_y1M22_g, dvec4(-0.2*w));
         }
 
+        // Convection between boundary layer and wall.
+        dvec4 q_convective = h_g * (filmcooled_T_wg - T_pdms);
+
+        // Simple radiation.
+        f64 emissivity_g = 0.15; // common for combustion products.
+        dvec4 q_radiative = emissivity_g * STEFAN_BOLTZMAN_CONSTANT
+                          * (sqed(sqed(T_g)) - sqed(sqed(T_pdms)));
+
+        q = q_convective + q_radiative;
 
-        f64 k_pdms = s->k_pdms;
-        f64 th_pdms = s->th_pdms;
+        // Heat balance to find wall temperatures at each side.
+        T_pdms = T_c + q*(Rth_pdms + Rth_iw + Rth_c);
+        T_wg = T_c + q*(Rth_iw + Rth_c);
+        T_wc = T_c + q*Rth_c;
+    }
+}
+
+// Sets up the wall heat balance of station `i` (see `thermal_walls_`),
+// iterating from `guess` with the wall limited around `prev` unless it's null
+// (at the exit).
+static void thermal_wall_init_(thermalWall_* wall, const simState* s,
+        const ContourSampler* smp, const thermalBartz* bartz,
+        const thermalGas_* gas, i32 i, thermalStation* stns, const f64* guess,
+        const f64* prev) {
+    *wall = (thermalWall_){
+        .s = s,
+        .bartz = bartz,
+        .gas = gas,
+        .stn = &stns[i],
+        .guess = { guess[0], guess[1], guess[2] },
+    };
+    if (prev) {
+        for (i32 j=0; j<3; ++j)
+            wall->prev[j] = prev[j];
+        f64 max_DTDz = 100e3;
+        wall->max_DT = max_DTDz * (smp->z[i + 1] - smp->z[i]);
+    }
+}
 
-        f64 k_iw = CuCr1Zr_k();
-        f64 k_web = CuCr1Zr_k();
+// Solves station `i` alone, its coolant side then its wall. Returns non-zero if
+// the coolant state is within the property approximations.
+static ALWAYSINLINE i32 thermal_wall_(const simState* s,
+        const ContourSampler* smp, const thermalBartz* bartz,
+        const thermalGas_* gas, i32 i, const f64* guess, const f64* prev,
+        thermalStation* stns, i64 coolant, i64 friction) {
+    i32 possible = thermal_coolant_(s, smp, gas, i, stns, coolant, friction);
+    thermalWall_* wall = &(thermalWall_){0};
+    thermal_wall_init_(wall, s, smp, bartz, gas, i, stns, guess, prev);
+    PROFILE_ZONE(PROFILE_wall)
+        thermal_walls_(wall, 1);
+    return possible;
+}
 
-        // Coolant convection coefficient.
-        f64 h_c = Nu_c*k_c/HD_c;
+// Carries the coolant state from station `i` to `i - 1` given the heat flux
+// over that length, returning zero if it ran out of pressure.
+static i32 thermal_continue_(const simState* s, const ContourSampler* smp,
+        const thermalGas_* gas, thermalStation* stns, i32 i, f64 q) {
+    i32 possible = 1;
+    f64 rA = smp->r[i];
+    f64 rB = smp->r[i - 1];
+    f64 Dell = smp->ell[i] - smp->ell[i - 1];
+    q = ifnan(q, 8e3); // try to wrangle some ok data.
 
-        // Model web as a fin.
-        f64 eta_web; {
-            f64 term = sqrt(2.0 * h_c * wi_web / k_web) * th_chnl / wi_chnl;
-            f64 exp_twoterm = exp2(LOG2E*2.0*term);
-            f64 tanh_term = (exp_twoterm - 1.0)
-                          / (exp_twoterm + 1.0);
-            eta_web = tanh_term / term;
-        }
-        // Correct for fin.
-        h_c *= (wi_chnl + 2.0*eta_web*th_chnl) / (wi_chnl + wi_web);
+    f64 dm_c = s->dm_fu * (1.0 + s->prop_fc);
+    f64 contact_area = PI*(rA + rB)*Dell;
+    stns[i - 1].T_c = stns[i].T_c + q*contact_area/dm_c/stns[i].cp_c;
+    assert(stns[i - 1].T_c > 0.0, "nonphysical property, T_c: %g",
+            stns[i - 1].T_c);
 
-        // Cylindrical conductor resistance.
-        f64 Rth_iw = rA * LN2*log2(1.0 + th_iw/rA) / k_iw;
-        f64 Rth_pdms = rA * LN2*log2(1.0 + th_pdms/rA) / k_pdms;
-        // Fin + convective resistance.
-        f64 Rth_c = 1.0 / h_c;
+    f64 DP_c = 0.5*stns[i].rho_c*sqed(stns[i].vel_c)*stns[i].ff_c/gas->HD_c
+             * Dell;
+    stns[i - 1].P_c = stns[i].P_c - DP_c;
+    if (stns[i - 1].P_c <= 0.0) {
+        possible = 0;
+        stns[i - 1].P_c = 1.0; // smile.
+    }
+    return possible;
+}
+
+// Marches the coolant through the channels, one station after another. Always
+// inlined so that each `thermal_sim_*` below is a copy specialised for its
+// coolant and friction factor. If `seed_gas` is non-null, `stns` holds a
+// converged parallel march (see below) and this is its final pass: the gas
+// state of every station is taken from `seed_gas`, and each wall is iterated
+// from its converged temperatures rather than the upstream wall's.
+static ALWAYSINLINE i32 thermal_march_(const simState* s, const Contour* cnt,
+        const ContourSampler* smp, const thermalBartz* bartz,
+        thermalStation* stns, stressStation* stress_stns,
+        const thermalGas_* seed_gas, i64 coolant, i64 friction) {
+    i32 possible_system = 1;
+
+    ceaFit* fit_gamma = &(ceaFit){0};
+    ceaFit* fit_cp = &(ceaFit){0};
+    ceaFit* fit_mu = &(ceaFit){0};
+    ceaFit* fit_Pr = &(ceaFit){0};
+    cea_fit_gamma(fit_gamma, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_cp(fit_cp, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_mu(fit_mu, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_Pr(fit_Pr, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+
+    coolantFilm_ film = coolant_film_(coolant);
+
+    i32 N = smp->N;
 
-        f64 prev_T_pdms;
-        f64 prev_T_wg;
-        f64 prev_T_wc;
+    if (seed_gas) {
+        stns[N - 1].T_c = s->T_fu0;
+        stns[N - 1].P_c = s->P_fu0;
+    } else {
+        stns[N - 1] = (thermalStation){
+            .T_c = s->T_fu0,
+            .P_c = s->P_fu0,
+        };
+    }
+    // March from nozzle exit to injector face.
+    for (i32 i=N - 1; i>-1; --i) {
+        thermalGas_* fresh = &(thermalGas_){0};
+        const thermalGas_* gas = fresh;
+        if (seed_gas)
+            gas = &seed_gas[i];
+        else
+            thermal_gas_(s, cnt, smp, fit_gamma, fit_cp, fit_mu, fit_Pr, &film,
+                    i, fresh);
+
+        // Start from the upstream wall (or the coolant, at the exit).
+        f64 T_c = stns[i].T_c;
+        f64 prev[3];
         if (i == N - 1) {
             // Guess.
-            prev_T_pdms = lerp(T_c, filmcooled_T_wg, 0.0);
-            prev_T_wg = lerp(T_c, filmcooled_T_wg, 0.0);
-            prev_T_wc = lerp(T_c, filmcooled_T_wg, 0.0);
+            prev[0] = lerp(T_c, gas->filmcooled_T_wg, 0.0);
+            prev[1] = lerp(T_c, gas->filmcooled_T_wg, 0.0);
+            prev[2] = lerp(T_c, gas->filmcooled_T_wg, 0.0);
         } else {
-            prev_T_pdms = stns[i + 1].T_pdms;
-            prev_T_wg = stns[i + 1].T_wg;
-            prev_T_wc = stns[i + 1].T_wc;
+            prev[0] = stns[i + 1].T_pdms;
+            prev[1] = stns[i + 1].T_wg;
+            prev[2] = stns[i + 1].T_wc;
         }
+        // Or from its converged wall, if seeded.
+        const f64* guess = prev;
+        f64 seed[3];
+        if (seed_gas) {
+            seed[0] = stns[i].T_pdms;
+            seed[1] = stns[i].T_wg;
+            seed[2] = stns[i].T_wc;
+            guess = seed;
+        }
+        possible_system &= thermal_wall_(s, smp, bartz, gas, i, guess,
+                (i == N - 1) ? NULL : prev, stns, coolant, friction);
+        if (stress_stns)
+            stress_station(s, smp, i, gas->P_g, &stns[i], &stress_stns[i]);
 
-        // Wall heat/temperature numerical search:
-        f64 q = NAN;
-        f64 h_g = NAN;
-        f64 T_pdms = prev_T_pdms;
-        f64 T_wg = prev_T_wg;
-        f64 T_wc = prev_T_wc;
-        f64 old_T_pdms = T_pdms;
-        f64 old_T_wg = T_wg;
-        f64 old_T_wc = T_wc;
-
-        for (i32 iter=0; /* true */; ++iter) {
-            enum { MAX_ITERS = 300 };
-            stns[i].xtra = iter;
-
-            i32 possible_rn = 1;
-
-            T_pdms = max(T_pdms, 250.0);
-            T_wg = max(T_wg, 250.0);
-            T_wc = max(T_wc, 250.0);
-
-            if (i != N - 1) {
-                f64 max_DTDz = 100e3;
-                f64 max_DT = max_DTDz * abs(zB - zA);
-
-                possible_rn &= (T_pdms > prev_T_pdms - max_DT);
-                possible_rn &= (T_pdms < prev_T_pdms + max_DT);
-                possible_rn &= (T_wg > prev_T_wg - max_DT);
-                possible_rn &= (T_wg < prev_T_wg + max_DT);
-                possible_rn &= (T_wc > prev_T_wc - max_DT);
-                possible_rn &= (T_wc < prev_T_wc + max_DT);
-                T_pdms = min(max(T_pdms, prev_T_pdms - max_DT),
-                             prev_T_pdms + max_DT);
-                T_wg = min(max(T_wg, prev_T_wg - max_DT), prev_T_wg + max_DT);
-                T_wc = min(max(T_wc, prev_T_wc - max_DT), prev_T_wc + max_DT);
-            }
+        // Do coolant property continuation if theres more channel left.
+        if (i > 0)
+            possible_system &= thermal_continue_(s, smp, gas, stns, i,
+                    stns[i].q);
+    }
 
-            if (iter >= MAX_ITERS) {
-                // possible_system = 0;
-                // eh let it slide.
-                break;
-            }
+    return possible_system;
+}
 
-            f64 diff_T_pdms = abs(T_pdms - old_T_pdms);
-            f64 diff_T_wg = abs(T_wg - old_T_wg);
-            f64 diff_T_wc = abs(T_wc - old_T_wc);
-            f64 max_diff = max(diff_T_pdms, max(diff_T_wg, diff_T_wc));
-            if (iter > 0 && possible_rn && max_diff < 5e-2)
-                break;
-
-            old_T_pdms = T_pdms;
-            old_T_wg = T_wg;
-            old_T_wc = T_wc;
-
-            // Bartz equation for convection coefficient.
-            {
-                // Use properties evauluated at the eckert temperature.
-                f64 T_gw = 0.5*T_pdms + 0.28*T0_g + 0.22*adiabatic_T_wg;
-                f64 min_T = T0_g * isentropic_T_on_T0(s->M_exit, shr_exit);
-                T_gw = min(max(T_gw, min_T), T0_g);
-                f64 M_gw = mach_for_temperature(T_gw / T0_g, fit_gamma);
-                assert(M_gw >= 0.0, "nonphysical property: M_gw=%g", M_gw);
-                // M_gw = min(M_gw, s->M_exit);
-                // upstream curvature?
-                f64 Rcurvature_tht = 1.5*cnt->R_tht;
-                f64 bartz_gamma_g = cea_sample(fit_gamma, M_gw);
-                f64 bartz_cp_g = cea_sample(fit_cp, M_gw);
-                f64 bartz_mu_g = cea_sample(fit_mu, M_gw);
-                f64 bartz_Pr_g = cea_sample(fit_Pr, M_gw);
-                f64 bartz_y1M22_g = 0.5*(bartz_gamma_g - 1.0)*sqed(M_g);
-                assert(bartz_mu_g > 0.0, "nonphysical property, bartz_mu_g: %g",
-                        bartz_mu_g);
-                assert(bartz_cp_g > 0.0, "nonphysical property, bartz_cp_g: %g",
-                        bartz_cp_g);
-                assert(bartz_Pr_g > 0.0, "nonphysical property, bartz_Pr_g: %g",
-                        bartz_Pr_g);
-                f64 w = 0.6; // common estimate.
-                h_g = 0.026
-                    * pow(bartz_mu_g, 0.2)
-                    * bartz_cp_g
-                    * pow(bartz_Pr_g, -0.6)
-                    * pow(dm_g/s->A_tht, 0.8)
-                    * pow(0.5/Rcurvature_tht/cnt->R_tht, 0.1)
-                    * pow(s->A_tht/A_g, 0.9)
-                    * pow(0.5*filmcooled_T_wg/T0_g*(1.0 + bartz_y1M22_g) + 0.5,
-                          0.2*w - 0.8)
-                    * pow(1.0 + bartz_y1M22_g, -0.2*w);
-            }
+#define THERMAL_SIM_(name, coolant, friction)                               \
+    static i32 thermal_sim_##name(const simState* s, const Contour* cnt,    \
+            const ContourSampler* smp, const thermalBartz* bartz,           \
+            thermalStation* stns, stressStation* stress_stns,               \
+            const thermalGas_* seed_gas) {                                  \
+        return thermal_march_(s, cnt, smp, bartz, stns, stress_stns,        \
+                seed_gas, coolant, friction);                               \
+    }
+THERMAL_SPECIALISATIONS(THERMAL_SIM_)
+#undef THERMAL_SIM_
+
+typedef i32 thermalSim_f_(const simState* s, const Contour* cnt,
+        const ContourSampler* smp, const thermalBartz* bartz,
+        thermalStation* stns, stressStation* stress_stns,
+        const thermalGas_* seed_gas);
+static thermalSim_f_* const thermal_sims_[COOLANT_COUNT][FRICTION_COUNT] = {
+    #define THERMAL_SIM_(name, coolant, friction)                           \
+        [coolant][friction] = thermal_sim_##name,
+    THERMAL_SPECIALISATIONS(THERMAL_SIM_)
+    #undef THERMAL_SIM_
+};
+
+// Parallel march, by predictor-corrector over the whole channel. Given a
+// prediction of the coolant state at every station (from the previous call),
+// every station's wall is solved independently across threads, then a serial
+// sweep re-marches the coolant using a linearisation of each station's heat
+// flux about its predicted coolant temperature. This repeats until the swept
+// coolant state matches the prediction. Since each wall solve only converges
+// to within its tolerance of wherever it started, a final serial march is then
+// made from the converged state, so that the result is that of the serial
+// march (to the wall tolerance) but with every wall starting from (nearly) its
+// solution.
+
+typedef struct thermalWorker_ {
+    const simState* s;
+    const Contour* cnt;
+    const ContourSampler* smp;
+    const thermalBartz* bartz;
+    const ceaFit* fit_gamma;
+    const ceaFit* fit_cp;
+    const ceaFit* fit_mu;
+    const ceaFit* fit_Pr;
+    thermalGas_* gas;
+    thermalStation* stns;
+    const f64* prev; // [3*N] wall temperatures prior to this solve.
+    f64* dqdT; // [N] heat flux sensitivity to coolant temperature.
+    f64* props; // [6*N] clamped T_c, P_c and then rho_c, cp_c, mu_c, k_c.
+    i32 lo; // stations [lo, hi).
+    i32 hi;
+    i32 first; // whether `gas` must also be filled.
+    i32 failed;
+    char msg[1024]; // assertion message, if failed.
+} thermalWorker_;
+
+static ALWAYSINLINE void thermal_worker_stations_(thermalWorker_* w,
+        i64 coolant, i64 friction) {
+    coolantFilm_ film = coolant_film_(coolant);
+    i32 N = w->smp->N;
+
+    // The predicted coolant states are all known, so look up the properties of
+    // every station at once.
+    f64* T_c = w->props + 0*N;
+    f64* P_c = w->props + 1*N;
+    f64* rho_c = w->props + 2*N;
+    f64* cp_c = w->props + 3*N;
+    f64* mu_c = w->props + 4*N;
+    f64* k_c = w->props + 5*N;
+    for (i32 i=w->lo; i<w->hi; ++i) {
+        T_c[i] = w->stns[i].T_c;
+        P_c[i] = w->stns[i].P_c;
+        assert(T_c[i] > 0.0, "nonphysical property, T_c: %g", T_c[i]);
+        assert(P_c[i] > 0.0, "nonphysical property, P_c: %g", P_c[i]);
+    }
+    coolant_properties_many_(coolant, w->hi - w->lo, T_c + w->lo,
+            P_c + w->lo, rho_c + w->lo, cp_c + w->lo, mu_c + w->lo,
+            k_c + w->lo);
+
+    for (i32 i=w->lo; i<w->hi; ++i) {
+        if (w->first)
+            thermal_gas_(w->s, w->cnt, w->smp, w->fit_gamma, w->fit_cp,
+                    w->fit_mu, w->fit_Pr, &film, i, &w->gas[i]);
+        thermalStation* stn = &w->stns[i];
+        thermal_coolant_at_(w->s, w->smp, &w->gas[i], i, w->stns, rho_c[i],
+                cp_c[i], mu_c[i], k_c[i], friction);
+
+        f64 guess[3] = { stn->T_pdms, stn->T_wg, stn->T_wc };
+        const f64* prev = (i == N - 1) ? NULL : &w->prev[3*(i + 1)];
+        thermalWall_* wall = &(thermalWall_){0};
+        thermal_wall_init_(wall, w->s, w->smp, w->bartz, &w->gas[i], i,
+                w->stns, guess, prev);
+        PROFILE_ZONE(PROFILE_wall)
+            thermal_walls_(wall, 1);
+        // Ignoring radiation and the bartz temperature dependance.
+        f64 Rth = w->gas[i].Rth_pdms + w->gas[i].Rth_iw + 1.0/stn->h_c;
+        w->dqdT[i] = -stn->h_g / (1.0 + stn->h_g*Rth);
+    }
+}
+#define THERMAL_WORKER_(name, coolant, friction)                             \
+    static void thermal_worker_##name##_(thermalWorker_* w) {               \
+        thermal_worker_stations_(w, coolant, friction);                     \
+    }
+THERMAL_SPECIALISATIONS(THERMAL_WORKER_)
+#undef THERMAL_WORKER_
+
+typedef void thermalWorkerStations_f_(thermalWorker_* w);
+static thermalWorkerStations_f_* const
+        thermal_workers_[COOLANT_COUNT][FRICTION_COUNT] = {
+    #define THERMAL_WORKER_(name, coolant, friction)                        \
+        [coolant][friction] = thermal_worker_##name##_,
+    THERMAL_SPECIALISATIONS(THERMAL_WORKER_)
+    #undef THERMAL_WORKER_
+};
+
+// One thread of a pool.
+typedef struct thermalPoolThread_ {
+    thermalPool* pool;
+    i32 index; // of its worker.
+    pthread_t thread;
+    i64 counts[COUNT_COUNT]; // of the thread, once stopped.
+} thermalPoolThread_;
+
+struct thermalPool {
+    pthread_mutex_t lock;
+    pthread_cond_t posted; // signalled once a pass is posted (or stopping).
+    pthread_cond_t finished; // signalled once every thread is done with it.
+    i64 pass; // how many passes have been posted.
+    i32 stopping;
+    i32 running; // threads yet to finish the current pass.
+    i32 active; // workers taking part in the current pass.
+    i32 count; // threads.
+    thermalPoolThread_ threads[THERMAL_MAX_THREADS];
+    thermalWorker_ ws[THERMAL_MAX_THREADS];
+
+    // Scratch space of the march, grown as needed.
+    i32 capacity; // stations.
+    thermalGas_* gas; // [capacity]
+    f64* buf; // [12*capacity]
+};
+
+// Runs one worker's share of a pass. Workers have their own assertion state, so
+// failures are left in the worker to be re-raised by the calling thread.
+static NEVERINLINE void thermal_worker_run_(thermalWorker_* w) {
+    w->failed = 0;
+    if (assertion_has_failed()) {
+        w->failed = 1;
+        __builtin_strncpy(w->msg, assertion_message(), numel(w->msg) - 1);
+        w->msg[numel(w->msg) - 1] = '\0';
+        return;
+    }
+    thermal_workers_[w->s->coolant][w->s->friction](w);
+}
+
+// Entrypoint of a pool thread, running its worker's share of every pass posted
+// until stopped.
+static void* thermal_pool_thread_(void* arg) {
+    thermalPoolThread_* t = arg;
+    thermalPool* pool = t->pool;
+    i64 seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->pass == seen && !pool->stopping)
+            pthread_cond_wait(&pool->posted, &pool->lock);
+        if (pool->stopping)
+            break;
+        seen = pool->pass;
+        i32 active = (t->index < pool->active);
+        pthread_mutex_unlock(&pool->lock);
+
+        if (active)
+            thermal_worker_run_(&pool->ws[t->index]);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0)
+            pthread_cond_signal(&pool->finished);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    // Fresh threads start from zero, so these are only its own.
+    for (i32 i=0; i<COUNT_COUNT; ++i)
+        t->counts[i] = profile_counts_[i];
+    return NULL;
+}
+
+thermalPool* thermal_pool_new(i64 threads) {
+    if (threads <= 1)
+        return NULL;
+    thermalPool* pool = malloc(sizeof(thermalPool));
+    if (pool == NULL)
+        return NULL;
+    *pool = (thermalPool){0};
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->posted, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+    // Any threads which can't be made are just left out.
+    for (i32 k=0; k<min(threads, THERMAL_MAX_THREADS); ++k) {
+        thermalPoolThread_* t = &pool->threads[pool->count];
+        t->pool = pool;
+        t->index = pool->count;
+        if (pthread_create(&t->thread, NULL, thermal_pool_thread_, t) == 0)
+            ++pool->count;
+    }
+    if (pool->count == 0) {
+        thermal_pool_free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void thermal_pool_free(thermalPool* pool) {
+    if (pool == NULL)
+        return;
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->posted);
+    pthread_mutex_unlock(&pool->lock);
+    for (i32 k=0; k<pool->count; ++k) {
+        pthread_join(pool->threads[k].thread, NULL);
+        profile_counts_merge(pool->threads[k].counts);
+    }
+    pthread_cond_destroy(&pool->finished);
+    pthread_cond_destroy(&pool->posted);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->gas);
+    free(pool->buf);
+    free(pool);
+}
+
+// Solves every station's wall, the first `active` workers each taking their
+// share on a pool thread (the calling thread only waits, so that an assertion
+// failing in a share can never unwind it while other shares are still running).
+// Any failed assertion is left in its worker.
+static void thermal_pool_run_(thermalPool* pool, i32 active) {
+    pthread_mutex_lock(&pool->lock);
+    pool->active = active;
+    pool->running = pool->count;
+    ++pool->pass;
+    pthread_cond_broadcast(&pool->posted);
+    while (pool->running > 0)
+        pthread_cond_wait(&pool->finished, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Returns 0 if it didn't converge, in which case `stns` is garbage.
+static i32 thermal_march_parallel_(thermalPool* pool, const simState* s,
+        const Contour* cnt, const ContourSampler* smp,
+        const thermalBartz* bartz, thermalStation* stns,
+        stressStation* stress_stns, i32* rstr possible_system) {
+    ceaFit* fit_gamma = &(ceaFit){0};
+    ceaFit* fit_cp = &(ceaFit){0};
+    ceaFit* fit_mu = &(ceaFit){0};
+    ceaFit* fit_Pr = &(ceaFit){0};
+    cea_fit_gamma(fit_gamma, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_cp(fit_cp, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_mu(fit_mu, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+    cea_fit_Pr(fit_Pr, s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+
+    i32 N = smp->N;
+    i32 count = min(min(s->thermal_threads, pool->count), N);
 
-            // Convection between boundary layer and wall.
-            f64 q_convective = h_g * (filmcooled_T_wg - T_pdms);
+    // Scratch space, kept by the pool (so nothing is lost if this fails).
+    if (pool->capacity < N) {
+        free(pool->gas);
+        free(pool->buf);
+        pool->gas = malloc(N * sizeof(thermalGas_));
+        pool->buf = malloc(12*N * sizeof(f64));
+        pool->capacity = (pool->gas && pool->buf) ? N : 0;
+        assert(pool->capacity, "failed to allocate thermal scratch");
+    }
+    thermalGas_* gas = pool->gas;
+    f64* prev = pool->buf; // [3*N]
+    f64* dqdT = pool->buf + 3*N;
+    f64* pred_T_c = pool->buf + 4*N;
+    f64* pred_P_c = pool->buf + 5*N;
+    f64* props = pool->buf + 6*N; // [6*N]
+
+    thermalWorker_* ws = pool->ws;
+    for (i32 k=0; k<count; ++k) {
+        ws[k] = (thermalWorker_){
+            .s = s,
+            .cnt = cnt,
+            .smp = smp,
+            .bartz = bartz,
+            .fit_gamma = fit_gamma,
+            .fit_cp = fit_cp,
+            .fit_mu = fit_mu,
+            .fit_Pr = fit_Pr,
+            .gas = gas,
+            .stns = stns,
+            .prev = prev,
+            .dqdT = dqdT,
+            .props = props,
+            .lo = (i32)((i64)N*k/count),
+            .hi = (i32)((i64)N*(k + 1)/count),
+        };
+    }
 
-            // Simple radiation.
-            f64 emissivity_g = 0.15; // common for combustion products.
-            f64 q_radiative = emissivity_g * STEFAN_BOLTZMAN_CONSTANT
-                            * (sqed(sqed(T_g)) - sqed(sqed(T_pdms)));
+    // Predict the coolant, assuming the channel pressure drop hasn't changed
+    // since the last march.
+    f64 DP_fu0 = s->P_fu0 - stns[N - 1].P_c;
+    for (i32 i=0; i<N; ++i)
+        stns[i].P_c = max(stns[i].P_c + DP_fu0, 1.0);
+    stns[N - 1].T_c = s->T_fu0;
+    stns[N - 1].P_c = s->P_fu0;
 
-            q = q_convective + q_radiative;
+    i32 converged = 0;
+    for (i32 iter=0; iter<THERMAL_MAX_PC_ITERS; ++iter) {
+        for (i32 i=0; i<N; ++i) {
+            prev[3*i + 0] = stns[i].T_pdms;
+            prev[3*i + 1] = stns[i].T_wg;
+            prev[3*i + 2] = stns[i].T_wc;
+            pred_T_c[i] = stns[i].T_c;
+            pred_P_c[i] = stns[i].P_c;
+        }
+        for (i32 k=0; k<count; ++k)
+            ws[k].first = (iter == 0);
 
-            // Heat balance to find wall temperatures at each side.
-            T_pdms = T_c + q*(Rth_pdms + Rth_iw + Rth_c);
-            T_wg = T_c + q*(Rth_iw + Rth_c);
-            T_wc = T_c + q*Rth_c;
+        thermal_pool_run_(pool, count);
+        for (i32 k=0; k<count; ++k) {
+            if (ws[k].failed)
+                assertion_rethrow(ws[k].msg);
         }
 
-        stns[i].q = q;
-        stns[i].h_g = h_g;
-        stns[i].h_c = h_c;
-        stns[i].vel_c = vel_c;
-        stns[i].rho_c = rho_c;
-        stns[i].ff_c = ff_c;
-        stns[i].Re_c = Re_c;
-        stns[i].Pr_c = Pr_c;
-        stns[i].T_gw = filmcooled_T_wg;
-        stns[i].T_pdms = T_pdms;
-        stns[i].T_wg = T_wg;
-        stns[i].T_wc = T_wc;
-
-        f64 Dell = hypot(rB - rA, zB - zA);
-        ell -= Dell;
+        // Correct. Note the other coolant properties are left as predicted,
+        // which only errs once the prediction is already off.
+        f64 max_DT_c = 0.0;
+        f64 max_DP_c = 0.0;
+        for (i32 i=N - 1; i>0; --i) {
+            f64 q = stns[i].q + dqdT[i]*(stns[i].T_c - pred_T_c[i]);
+            thermal_continue_(s, smp, &gas[i], stns, i, q);
+            max_DT_c = max(max_DT_c, abs(stns[i - 1].T_c - pred_T_c[i - 1]));
+            max_DP_c = max(max_DP_c, abs(stns[i - 1].P_c - pred_P_c[i - 1]));
+        }
+        if (max_DT_c < 1e-3 && max_DP_c < 1.0) {
+            converged = 1;
+            break;
+        }
+    }
+    if (!converged)
+        return 0;
 
-        // Do coolant property continuation if theres more channel left.
-        if (i > 0) {
-            q = ifnan(q, 8e3); // try to wrangle some ok data.
-
-            f64 contact_area = PI*(rA + rB)*Dell;
-            stns[i - 1].T_c = T_c + q*contact_area/dm_c/cp_c;
-            assert(stns[i - 1].T_c > 0.0, "nonphysical property, T_c: %g",
-                    stns[i - 1].T_c);
-
-            f64 DP_c = 0.5*rho_c*sqed(vel_c)*ff_c/HD_c * Dell;
-            stns[i - 1].P_c = P_c - DP_c;
-            if (stns[i - 1].P_c <= 0.0) {
-                possible_system = 0;
-                stns[i - 1].P_c = 1.0; // smile.
+    // Final pass, from the converged walls.
+    *possible_system = thermal_sims_[s->coolant][s->friction](s, cnt, smp,
+            bartz, stns, stress_stns, gas);
+    return 1;
+}
+
+// Lane-batched march, specialised as `thermal_march_` is (every lane sharing
+// the coolant and friction factor).
+static ALWAYSINLINE void thermal_march_lanes_(thermalLane* lanes, i32 count,
+        i64 coolant, i64 friction) {
+    i32 N = lanes[0].smp->N;
+
+    coolantFilm_ film = coolant_film_(coolant);
+    ceaFit fits[THERMAL_LANES][4];
+    for (i32 k=0; k<count; ++k) {
+        const simState* s = lanes[k].s;
+        assert(lanes[k].smp->N == N, "lanes must have the same station count "
+                "(%d vs %d)", lanes[k].smp->N, N);
+        cea_fit_gamma(&fits[k][0], s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+        cea_fit_cp(&fits[k][1], s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+        cea_fit_mu(&fits[k][2], s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+        cea_fit_Pr(&fits[k][3], s->P0_cc, s->ofr, s->AEAT, s->M_exit);
+
+        lanes[k].possible = 1;
+        lanes[k].stns[N - 1] = (thermalStation){
+            .T_c = s->T_fu0,
+            .P_c = s->P_fu0,
+        };
+    }
+
+    // March every design from nozzle exit to injector face together, each
+    // station's walls being solved across lanes.
+    for (i32 i=N - 1; i>-1; --i) {
+        thermalGas_ gas[THERMAL_LANES];
+        thermalWall_ walls[THERMAL_LANES];
+        for (i32 k=0; k<count; ++k) {
+            thermalLane* lane = &lanes[k];
+            const simState* s = lane->s;
+            const ContourSampler* smp = lane->smp;
+            thermalStation* stns = lane->stns;
+            thermal_gas_(s, lane->cnt, smp, &fits[k][0], &fits[k][1],
+                    &fits[k][2], &fits[k][3], &film, i, &gas[k]);
+            lane->possible &= thermal_coolant_(s, smp, &gas[k], i, stns,
+                    coolant, friction);
+
+            // Start from the upstream wall (or the coolant, at the exit).
+            f64 T_c = stns[i].T_c;
+            f64 prev[3];
+            if (i == N - 1) {
+                // Guess.
+                prev[0] = lerp(T_c, gas[k].filmcooled_T_wg, 0.0);
+                prev[1] = lerp(T_c, gas[k].filmcooled_T_wg, 0.0);
+                prev[2] = lerp(T_c, gas[k].filmcooled_T_wg, 0.0);
+            } else {
+                prev[0] = stns[i + 1].T_pdms;
+                prev[1] = stns[i + 1].T_wg;
+                prev[2] = stns[i + 1].T_wc;
             }
+            thermal_wall_init_(&walls[k], s, smp, lane->bartz, &gas[k], i,
+                    stns, prev, (i == N - 1) ? NULL : prev);
+        }
+
+        PROFILE_ZONE(PROFILE_wall)
+            thermal_walls_(walls, count);
+
+        for (i32 k=0; k<count; ++k) {
+            thermalLane* lane = &lanes[k];
+            if (lane->stress_stns)
+                stress_station(lane->s, lane->smp, i, gas[k].P_g,
+                        &lane->stns[i], &lane->stress_stns[i]);
+            if (i > 0)
+                lane->possible &= thermal_continue_(lane->s, lane->smp,
+                        &gas[k], lane->stns, i, lane->stns[i].q);
         }
     }
+}
 
-    return possible_system;
+#define THERMAL_SIM_LANES_(name, coolant, friction)                         \
+    static void thermal_sim_lanes_##name(thermalLane* lanes, i32 count) {   \
+        thermal_march_lanes_(lanes, count, coolant, friction);              \
+    }
+THERMAL_SPECIALISATIONS(THERMAL_SIM_LANES_)
+#undef THERMAL_SIM_LANES_
+
+typedef void thermalSimLanes_f_(thermalLane* lanes, i32 count);
+static thermalSimLanes_f_* const
+        thermal_sims_lanes_[COOLANT_COUNT][FRICTION_COUNT] = {
+    #define THERMAL_SIM_LANES_(name, coolant, friction)                     \
+        [coolant][friction] = thermal_sim_lanes_##name,
+    THERMAL_SPECIALISATIONS(THERMAL_SIM_LANES_)
+    #undef THERMAL_SIM_LANES_
+};
+
+void thermal_sim_lanes(thermalLane* lanes, i32 count) {
+    assert(1 <= count && count <= THERMAL_LANES, "invalid lane count: %d",
+            count);
+    const simState* s = lanes[0].s;
+    for (i32 k=1; k<count; ++k) {
+        assert(lanes[k].s->coolant == s->coolant
+                && lanes[k].s->friction == s->friction,
+                "lanes must share the coolant and friction factor");
+    }
+    COUNT_ADD(marches, count);
+    thermal_sims_lanes_[s->coolant][s->friction](lanes, count);
+}
+
+i32 thermal_sim(const simState* s, const Contour* cnt,
+        const ContourSampler* smp, const thermalBartz* bartz,
+        thermalStation* stns, stressStation* stress_stns, i32 warm,
+        thermalPool* pool) {
+    COUNT_ADD(marches, 1);
+    if (warm && pool != NULL && s->thermal_threads > 1) {
+        i32 possible;
+        if (thermal_march_parallel_(pool, s, cnt, smp, bartz, stns,
+                stress_stns, &possible))
+            return possible;
+        // Otherwise fall back to the serial march.
+    }
+    return thermal_sims_[s->coolant][s->friction](s, cnt, smp, bartz, stns,
+            stress_stns, NULL);
 }
@@ -11,6 +11,7 @@ typedef struct thermalStation {
     f64 h_c;
     f64 vel_c;
     f64 rho_c;
+    f64 cp_c;
     f64 ff_c;
     f64 Re_c;
     f64 Pr_c;
@@ -23,5 +24,70 @@ typedef struct thermalStation {
     f64 xtra;
 } thermalStation;
 
-i32 thermal_sim(const simState* s, const Contour* cnt, thermalStation* stns,
-        i32 N);
+// The properties used by Bartz are evaluated at the Eckert temperature, so for
+// a given combustion they only depend on `T_gw/T0` (through the mach number
+// which gives that temperature). Since finding that mach is itself an
+// iteration, they are tabulated once per simulation instead of every wall
+// iteration. Tables are against `u = sqrt(T0/T_gw - 1)` (to which mach is near
+// proportional) and split at sonic, where the cea fits have a kink.
+#define THERMAL_BARTZ_N (64)
+typedef struct thermalBartz {
+    f64 u_sonic; // u at `M_gw = 1`, between the two halves.
+    f64 u_exit; // u at the exit temperature, the largest considered.
+    // Both indexed [subsonic/supersonic][u].
+    f64 gamma[2][THERMAL_BARTZ_N];
+    f64 group[2][THERMAL_BARTZ_N]; // `mu^0.2 * cp * Pr^-0.6`.
+} thermalBartz;
+
+// Tabulates the Bartz properties for the combustion of `s`.
+void thermal_bartz_init(thermalBartz* bartz, const simState* s);
+
+// See "stress.h" (which needs this header).
+typedef struct stressStation stressStation;
+
+// Parallel march limits. It gives up (and marches serially) if the coolant
+// state hasn't settled after this many predictor-corrector iterations, which
+// only happens when the prediction was poor.
+#define THERMAL_MAX_THREADS (64)
+#define THERMAL_MAX_PC_ITERS (8)
+
+// Threads of the parallel march, made once and then reused by every march given
+// them (typically for a whole execution). Returns null if `threads` is at most
+// one or no thread could be made, in which case marches are serial.
+typedef struct thermalPool thermalPool;
+thermalPool* thermal_pool_new(i64 threads);
+
+// Stops and frees the threads of `pool` (which may be null), adding their
+// counts to the calling thread's.
+void thermal_pool_free(thermalPool* pool);
+
+// Marches the coolant over the stations of `smp`, filling `stns` (which must
+// have `smp->N` entries). If `warm`, `stns` must hold the result of a previous
+// call on the same stations (only `P_fu0` having changed), which is then used
+// as the initial prediction for the parallel march (over up to
+// `s->thermal_threads` threads of `pool`). Otherwise, or if single-threaded,
+// the stations are marched one after another. If `stress_stns` is non-null
+// (also `smp->N` entries), each station's stresses are evaluated as soon as its
+// wall is solved, reusing the gas state rather than re-solving it on another
+// grid.
+i32 thermal_sim(const simState* s, const Contour* cnt,
+        const ContourSampler* smp, const thermalBartz* bartz,
+        thermalStation* stns, stressStation* stress_stns, i32 warm,
+        thermalPool* pool);
+
+// Lane-batched march, where up to `THERMAL_LANES` independent designs are
+// marched in lockstep and their walls solved together as vectors. Each lane is
+// identical to its own serial `thermal_sim`, and all must have the same number
+// of stations, coolant and friction factor (which are dispatched on once, as in
+// `thermal_sim`).
+#define THERMAL_LANES (4)
+typedef struct thermalLane {
+    const simState* s;
+    const Contour* cnt;
+    const ContourSampler* smp;
+    const thermalBartz* bartz;
+    thermalStation* stns;
+    stressStation* stress_stns; // may be null, as in `thermal_sim`.
+    i32 possible; // output, same as the return of `thermal_sim`.
+} thermalLane;
+void thermal_sim_lanes(thermalLane* lanes, i32 count);
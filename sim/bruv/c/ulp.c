@@ -0,0 +1,180 @@
+#if defined(ULP) && ULP
+
+#include "br.h"
+
+#include "assertion.h"
+#include "maths.h"
+#include "rand.h"
+
+
+// Checks the lane-wise `dvec2`/`dvec4` elementary functions against their
+// scalar `f64` versions, over sweeps of their input ranges plus random bit
+// patterns (so every exponent, sign and edge case). Fails if any lane is
+// further than `ULP_MAX_ERROR` from the scalar result.
+
+
+// The vector versions run the same arithmetic as the scalar ones, so they must
+// match exactly. Note the sign of a zero isn't counted (see `ulp_distance`).
+#define ULP_MAX_ERROR (0)
+
+// Inputs checked per function (and per vector width).
+#define ULP_COUNT (1 << 22)
+
+
+// Distance between `a` and `b` in ulps. +-0 are the same point, and nans only
+// match other nans (anything else is infinitely far).
+static u64 ulp_distance(f64 a, f64 b) {
+    if (isnan(a) || isnan(b))
+        return (isnan(a) && isnan(b)) ? 0 : ~(u64)0;
+    // Map the bits onto a monotonic integer line, with both zeroes at 0.
+    i64 x = (i64)fp_bits(a);
+    i64 y = (i64)fp_bits(b);
+    if (x < 0)
+        x = (i64)((u64)1 << 63) - x;
+    if (y < 0)
+        y = (i64)((u64)1 << 63) - y;
+    return (x > y) ? (u64)x - (u64)y : (u64)y - (u64)x;
+}
+
+
+// Every function is checked as `f(x, y)`, single argument ones ignoring `y`.
+#define ULP_FUNCS(X)                                                        \
+    X(exp2, exp2(x),    -1100.0, 1100.0,    0.0,  0.0)                      \
+    X(log2, log2(x),        0.0,   10.0,    0.0,  0.0)                      \
+    X(cbrt, cbrt(x),      -10.0,   10.0,    0.0,  0.0)                      \
+    X(pow,  pow(x, y),      0.0,   10.0,  -50.0, 50.0)
+
+#define X(name, expr, ...)                                                  \
+    static f64 ulp_##name##_f64_(f64 x, f64 y) {                            \
+        (void)y;                                                            \
+        return expr;                                                        \
+    }                                                                       \
+    static dvec2 ulp_##name##_dvec2_(dvec2 x, dvec2 y) {                    \
+        (void)y;                                                            \
+        return expr;                                                        \
+    }                                                                       \
+    static dvec4 ulp_##name##_dvec4_(dvec4 x, dvec4 y) {                    \
+        (void)y;                                                            \
+        return expr;                                                        \
+    }
+ULP_FUNCS(X)
+#undef X
+
+typedef f64 ulpScalar_f(f64 x, f64 y);
+typedef dvec2 ulpLanes2_f(dvec2 x, dvec2 y);
+typedef dvec4 ulpLanes4_f(dvec4 x, dvec4 y);
+typedef struct ulpFunc {
+    const char* name;
+    ulpScalar_f* scalar;
+    ulpLanes2_f* lanes2;
+    ulpLanes4_f* lanes4;
+    f64 xlo; // swept range of `x`.
+    f64 xhi;
+    f64 ylo; // random range of `y`.
+    f64 yhi;
+} ulpFunc;
+
+static const ulpFunc ulp_funcs[] = {
+    #define X(name, expr, xlo, xhi, ylo, yhi)                               \
+        { #name, ulp_##name##_f64_, ulp_##name##_dvec2_,                    \
+          ulp_##name##_dvec4_, xlo, xhi, ylo, yhi },
+    ULP_FUNCS(X)
+    #undef X
+};
+
+
+// Edge cases, every pair of which is checked first.
+static f64 ulp_edges[] = {
+    NAN, INF, -INF, 0.0, -0.0, 1.0, -1.0, 0.5, 2.0, 3.0, -8.0,
+    -1022.0, -1021.999, 1023.999, 1024.0,
+    0.0 /* subnorm min */, 0.0 /* subnorm max */, 0.0 /* norm min */,
+    0.0 /* max */,
+};
+static void ulp_edges_init(void) {
+    i32 n = numel(ulp_edges);
+    ulp_edges[n - 4] = fp_subnorm_min(f64);
+    ulp_edges[n - 3] = fp_subnorm_max(f64);
+    ulp_edges[n - 2] = fp_norm_min(f64);
+    ulp_edges[n - 1] = fp_from_bits((u64)0x7FEFFFFFFFFFFFFFULL);
+}
+
+// Returns the `i`th input pair of `f`.
+static void ulp_input(const ulpFunc* f, brRand* rand, i64 i, f64* x, f64* y) {
+    i64 edges = numel(ulp_edges);
+    if (i < edges*edges) {
+        *x = ulp_edges[i / edges];
+        *y = ulp_edges[i % edges];
+        return;
+    }
+    // Alternate sweeping `x` over its range with entirely random bits, and
+    // likewise for `y` (every other random `x`).
+    if (i % 2)
+        *x = lerpidx(f->xlo, f->xhi, (f64)i, (f64)ULP_COUNT);
+    else
+        *x = fp_from_bits(rand_u64(rand));
+    if (i % 4 == 2)
+        *y = fp_from_bits(rand_u64(rand));
+    else
+        *y = lerp(f->ylo, f->yhi, rand_0to1(rand));
+}
+
+typedef struct ulpWorst {
+    u64 ulps;
+    f64 x;
+    f64 y;
+} ulpWorst;
+
+static void ulp_update(ulpWorst* worst, f64 got, f64 expect, f64 x, f64 y) {
+    u64 ulps = ulp_distance(got, expect);
+    if (ulps > worst->ulps)
+        *worst = (ulpWorst){ ulps, x, y };
+}
+
+static void ulp_check(const ulpFunc* f) {
+    ulpWorst worst2 = {0};
+    ulpWorst worst4 = {0};
+    brRand* rand = &(brRand){0};
+    rand_seed(rand, 0x0BAD5EED);
+    for (i64 i=0; i<ULP_COUNT; i += 4) {
+        f64 x[4];
+        f64 y[4];
+        f64 expect[4];
+        for (i32 k=0; k<4; ++k) {
+            ulp_input(f, rand, i + k, &x[k], &y[k]);
+            expect[k] = f->scalar(x[k], y[k]);
+        }
+        dvec4 got4 = f->lanes4(dvec4(x[0], x[1], x[2], x[3]),
+                dvec4(y[0], y[1], y[2], y[3]));
+        dvec2 got2lo = f->lanes2(dvec2(x[0], x[1]), dvec2(y[0], y[1]));
+        dvec2 got2hi = f->lanes2(dvec2(x[2], x[3]), dvec2(y[2], y[3]));
+        for (i32 k=0; k<4; ++k) {
+            ulp_update(&worst4, got4[k], expect[k], x[k], y[k]);
+            f64 got2 = (k < 2) ? got2lo[k] : got2hi[k - 2];
+            ulp_update(&worst2, got2, expect[k], x[k], y[k]);
+        }
+    }
+
+    printf("%-5s max error: dvec2 %llu ulp, dvec4 %llu ulp (over %d inputs)\n",
+            f->name, worst2.ulps, worst4.ulps, ULP_COUNT);
+    assert(worst2.ulps <= ULP_MAX_ERROR, "%s dvec2 is %llu ulp off scalar at "
+            "x=%.17g, y=%.17g", f->name, worst2.ulps, worst2.x, worst2.y);
+    assert(worst4.ulps <= ULP_MAX_ERROR, "%s dvec4 is %llu ulp off scalar at "
+            "x=%.17g, y=%.17g", f->name, worst4.ulps, worst4.x, worst4.y);
+}
+
+
+i32 main(void);
+i32 main(void) {
+    if (assertion_has_failed()) {
+        printf("%s\n", assertion_message());
+        return 1;
+    }
+
+    ulp_edges_init();
+    for (i32 i=0; i<numel(ulp_funcs); ++i)
+        ulp_check(&ulp_funcs[i]);
+    printf("all within %d ulp.\n", ULP_MAX_ERROR);
+    return 0;
+}
+
+#endif
@@ -18,6 +18,36 @@ from . import paths
 __all__ = ["run"]
 
 
+# Zones of the c profiler, matching `PROFILE_ZONES` in "c/profile.h".
+PROFILE_ZONES = [
+    "execute",
+    "optimise",
+    "combustion",
+    "contour",
+    "fu0_loop",
+    "march",
+    "wall",
+    "colebrook",
+    "isentropic",
+    "stress",
+    "outputs",
+]
+
+# Operation counts of the c, matching `PROFILE_COUNTS` in "c/profile.h".
+PROFILE_COUNTS = [
+    "optimiser_iters",
+    "marches",
+    "wall_iters",
+    "wall_iters_max",
+    "colebrook_iters",
+    "isentropic_iters",
+    "mach_for_temperature_iters",
+    "cea_lookups",
+    "ipa_lookups",
+    "ethanol_lookups",
+]
+
+
 def get_interpretation():
     interp = bridge.Interpretation()
     IN = interp.INPUT
@@ -50,8 +80,12 @@ def get_interpretation():
     interp.append("wi_chnl", interp.F64, OUT)
     interp.append("psi_chnl", interp.F64, OUT)
     interp.append("eps_chnl", interp.F64, IN)
+    interp.append("friction", interp.I64, IN)
     interp.append("Pr_fu", interp.F64, IN)
     interp.append("T_fu0", interp.F64, IN)
+    interp.append("coolant", interp.I64, IN)
+    interp.append("thermal_threads", interp.I64, IN)
+    interp.append("fused_stress", interp.I64, IN)
     interp.append("P_fu0", interp.F64, OUT)
     interp.append("T_fu1", interp.F64, OUT)
     interp.append("P_fu1", interp.F64, OUT)
@@ -129,6 +163,14 @@ def get_interpretation():
     interp.append("optimise_th_chnl", interp.I64, IN)
     interp.append("optimise_prop_chnl", interp.I64, IN)
 
+    # Only non-zero when the c is built with `-DSIM_PROFILE=1`.
+    for zone in PROFILE_ZONES:
+        interp.append(f"prof_{zone}_time", interp.F64, OUT)
+        interp.append(f"prof_{zone}_hits", interp.I64, OUT)
+        interp.append(f"prof_{zone}_iters", interp.I64, OUT)
+    for name in PROFILE_COUNTS:
+        interp.append(f"count_{name}", interp.I64, OUT)
+
     interp.finalise()
     return interp
 
@@ -153,61 +195,29 @@ def get_state(interp):
     state["th_chnl"] = 1.5e-3
     state["prop_chnl"] = 0.6
     state["eps_chnl"] = 135e-6
+    state["friction"] = 2 # 0 = colebrook, 1 = serghides, 2 = goudar-sonnad.
     state["Pr_fu"] = config["operating_conditions"]["Pr_IPA"]
     state["T_fu0"] = config["operating_conditions"]["T_IPA"]
+    state["coolant"] = 0 # 0 = ipa, 1 = ethanol.
+    state["thermal_threads"] = 1 # 1 = serial coolant march.
+    state["fused_stress"] = 0 # 1 = stresses on the thermal stations.
 
     state["ofr"] = 1.4
     state["dm_cc"] = 2.152551267131888
     state["P_exit"] = config["operating_conditions"]["P_exit"]
     state["P0_cc"] = config["operating_conditions"]["P_cc"]
 
+    # Every output array is a row of one block (likewise the exports), which
+    # makes a whole result a single contiguous buffer.
     state["out_count"] = 1000
-    new_out = lambda: np.empty(shape=(state["out_count"],), dtype=np.float64)
-    state["out_z"] = new_out()
-    state["out_r"] = new_out()
-    state["out_M_g"] = new_out()
-    state["out_T_g"] = new_out()
-    state["out_P_g"] = new_out()
-    state["out_rho_g"] = new_out()
-    state["out_gamma_g"] = new_out()
-    state["out_cp_g"] = new_out()
-    state["out_mu_g"] = new_out()
-    state["out_Pr_g"] = new_out()
-    state["out_T_c"] = new_out()
-    state["out_P_c"] = new_out()
-    state["out_T_gw"] = new_out()
-    state["out_T_pdms"] = new_out()
-    state["out_T_wg"] = new_out()
-    state["out_T_wc"] = new_out()
-    state["out_q"] = new_out()
-    state["out_h_g"] = new_out()
-    state["out_h_c"] = new_out()
-    state["out_vel_c"] = new_out()
-    state["out_rho_c"] = new_out()
-    state["out_ff_c"] = new_out()
-    state["out_Re_c"] = new_out()
-    state["out_Pr_c"] = new_out()
-    state["out_startup_sigma"] = new_out()
-    state["out_startup_Ys"] = new_out()
-    state["out_startup_SF"] = new_out()
-    state["out_sigmah_pressure"] = new_out()
-    state["out_sigmah_thermal"] = new_out()
-    state["out_sigmah_bending"] = new_out()
-    state["out_sigmah"] = new_out()
-    state["out_sigmam"] = new_out()
-    state["out_sigma_vm"] = new_out()
-    state["out_Ys"] = new_out()
-    state["out_SF"] = new_out()
-    state["out_xtra"] = new_out()
+    state.arena([name for name in interp.names()
+                 if name.startswith("out_") and name != "out_count"],
+                state["out_count"])
 
     state["export_count"] = 3000
-    new_export = lambda: np.empty(shape=(state["export_count"],),
-            dtype=np.float64)
-    state["export_z"] = new_export()
-    state["export_helix_angle"] = new_export()
-    state["export_th_chnl"] = new_export()
-    state["export_psi_chnl"] = new_export()
-    state["export_th_iw"] = new_export()
+    state.arena([name for name in interp.names()
+                 if name.startswith("export_") and name != "export_count"],
+                state["export_count"])
 
     state["target_Thrust"] = config["operating_conditions"]["Thrust"]
     state["optimise_ofr"] = 0
@@ -361,6 +371,46 @@ def write_ammendments(state):
 
 
 
+def print_profile(state):
+    grand_total = state["prof_execute_time"]
+    if state["prof_execute_hits"] == 0:
+        return # not compiled in.
+
+    print(f" {'zone':<12} | total [s] | ave. [us] | share  | iters")
+    print(" ---------------------------------------------------------")
+    for zone in PROFILE_ZONES:
+        total = state[f"prof_{zone}_time"]
+        hits = state[f"prof_{zone}_hits"]
+        iters = state[f"prof_{zone}_iters"]
+        share = total / grand_total * 100.0
+        ave = f"{total / hits * 1e6:9.4f}" if hits > 1 else "        -"
+        print(f" {zone:<12} | {total:9.4f} | {ave} | {share:5.1f}% | {iters}")
+
+
+def execute_watched(state):
+    """
+    Executes the state in the background, printing the optimiser's progress as it
+    goes. A keyboard interrupt cancels the execution (at its next cost
+    evaluation). Returns as per `State.execute`.
+    """
+    execution = state.execute_async()
+    last = 0
+    try:
+        while not execution.poll():
+            p = execution.progress()
+            if p["evaluations"] != last:
+                last = p["evaluations"]
+                print(f"optimising: iteration {p['iterations']}, "
+                      f"{p['evaluations']} evaluations, "
+                      f"best cost ${p['best_cost']:.6g}", end="\r")
+            time.sleep(0.05)
+    except KeyboardInterrupt:
+        execution.cancel()
+    if last:
+        print()
+    return execution.result()
+
+
 def now_this_is_bruv():
     interp = get_interpretation()
     state = get_state(interp)
@@ -375,12 +425,13 @@ def now_this_is_bruv():
             end = time.perf_counter()
             print(f"{label} took {end - start:.4g} s.")
     with time_me("Simulation"):
-        ret = state.execute()
+        ret = execute_watched(state)
     if ret is not None:
         print("FAILED:", ret)
         return 1
 
     print(state)
+    print_profile(state)
     write_ammendments(state)
 
     get_out = lambda s: state[f"out_{s}"].view(state["out_count"])
@@ -215,6 +215,8 @@ C = BRUV / "c"
 
 BRIDGE = BRUV / "bridge"
 
+TBL = BRUV / "tbl"
+
 BIN = ROOT / "bin"
 BIN_C = BIN / "c"
 BIN_BRIDGE = BIN / "bridge"
@@ -237,6 +239,7 @@ else:
     C_LIB = BIN_C / f"lib{C_LIB_NAME}.so"
     C_STUBS = None
 C_CACHE = BIN_C / "cache.json"
+C_TABLES = BIN_C / "tables.bin"
 
 BRIDGE_MODULE_NAME = "bridge_cythonised"
 BRIDGE_CACHE = BIN_BRIDGE / "cache.json"
@@ -250,6 +253,16 @@ DECI_PREPRO = OUT / "deci.i"
 DECI_DISAS  = OUT / "deci.s"
 DECI_OBJ    = OUT / "deci.o"
 
+ULP_EXE    = OUT / "ulp.exe"
+ULP_PREPRO = OUT / "ulp.i"
+ULP_DISAS  = OUT / "ulp.s"
+ULP_OBJ    = OUT / "ulp.o"
+
+MARCH_EXE    = OUT / "march.exe"
+MARCH_PREPRO = OUT / "march.i"
+MARCH_DISAS  = OUT / "march.s"
+MARCH_OBJ    = OUT / "march.o"
+
 
 PATHS_PY = BRUV / "paths.py"
 BUILD_PY = BRUV / "build.py"
@@ -276,6 +289,15 @@ def bridge_deps():
     return paths
 
 
+def tables_deps():
+    paths = subfiles(TBL, ext=".i")
+    paths.append(BUILD_PY) # always depends on builder.
+    for p in paths:
+        if not p.is_file():
+            raise FileNotFoundError(f"missing table dependancy: {shortstr(p)}")
+    return paths
+
+
 def c_built(): # not necessarily all existent.
     paths = [C_CACHE]
     paths.append(C_LIB)
@@ -283,6 +305,9 @@ def c_built(): # not necessarily all existent.
         paths.append(C_STUBS)
     return paths
 
+def tables_built(): # not necessarily all existent.
+    return [C_TABLES]
+
 def bridge_built(): # not necessarily all existent.
     paths = [BRIDGE_CACHE]
     # Finding the "correct" compiled bridge file exists is lowk hard, so instead
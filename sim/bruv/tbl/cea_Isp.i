@@ -1,4 +1,8 @@
 /* LUT for cea_Isp */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.018%, rel 0.0518% */
 static const f32 tbl[6400] = {
     2.00227679e+02f, 2.02484009e+02f, 2.04631121e+02f, 2.06660273e+02f, 
     2.08585821e+02f, 2.10395204e+02f, 2.12108217e+02f, 2.13725690e+02f, 
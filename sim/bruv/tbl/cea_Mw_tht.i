@@ -1,4 +1,8 @@
 /* LUT for cea_Mw_tht */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.00724%, rel 0.016% */
 static const f32 tbl[6400] = {
     1.71680003e-02f, 1.73834565e-02f, 1.75988492e-02f, 1.78135696e-02f, 
     1.80266341e-02f, 1.82389624e-02f, 1.84491658e-02f, 1.86580264e-02f, 
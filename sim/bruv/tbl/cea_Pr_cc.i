@@ -1,4 +1,8 @@
 /* LUT for cea_Pr_cc */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0571%, rel 0.254% */
 static const f32 tbl[6400] = {
     5.20190001e-01f, 5.14166697e-01f, 5.06614327e-01f, 4.97804313e-01f, 
     4.88103671e-01f, 4.77967219e-01f, 4.67909738e-01f, 4.58300137e-01f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_Pr_exit */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.537%, rel 1.93% */
 static const f32 tbl[6400] = {
     5.49267866e-01f, 5.54515774e-01f, 5.59695329e-01f, 5.64743767e-01f, 
     5.69564740e-01f, 5.74027282e-01f, 5.78050424e-01f, 5.81513748e-01f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_Pr_lowm */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0587%, rel 0.27% */
 static const f32 tbl[6400] = {
     5.43209843e-01f, 5.43326652e-01f, 5.41979652e-01f, 5.39047497e-01f, 
     5.34416108e-01f, 5.28003951e-01f, 5.20220398e-01f, 5.11333483e-01f, 
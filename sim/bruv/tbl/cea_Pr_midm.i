@@ -1,4 +1,8 @@
 /* LUT for cea_Pr_midm */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.469%, rel 1.71% */
 static const f32 tbl[6400] = {
     5.50163274e-01f, 5.55271391e-01f, 5.60244642e-01f, 5.64996247e-01f, 
     5.69408086e-01f, 5.73297292e-01f, 5.76580092e-01f, 5.79102606e-01f, 
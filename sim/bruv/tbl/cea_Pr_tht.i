@@ -1,4 +1,8 @@
 /* LUT for cea_Pr_tht */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0613%, rel 0.29% */
 static const f32 tbl[6400] = {
     5.41119993e-01f, 5.40449088e-01f, 5.38209355e-01f, 5.34306814e-01f, 
     5.28698729e-01f, 5.21383813e-01f, 5.12828116e-01f, 5.03363822e-01f, 
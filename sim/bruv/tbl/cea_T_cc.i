@@ -1,4 +1,8 @@
 /* LUT for cea_T_cc */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0201%, rel 0.0405% */
 static const f32 tbl[6400] = {
     2.17250000e+03f, 2.24154811e+03f, 2.30865190e+03f, 2.37361133e+03f, 
     2.43643156e+03f, 2.49660385e+03f, 2.55451265e+03f, 2.60997088e+03f, 
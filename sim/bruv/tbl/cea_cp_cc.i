@@ -1,4 +1,8 @@
 /* LUT for cea_cp_cc */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0763%, rel 0.041% */
 static const f32 tbl[6400] = {
     2.45880005e+03f, 2.48528610e+03f, 2.51877719e+03f, 2.56001266e+03f, 
     2.61000515e+03f, 2.67011392e+03f, 2.73974439e+03f, 2.81917740e+03f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_cp_exit */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 2.29%, rel 1.1% */
 static const f32 tbl[6400] = {
     2.32396331e+03f, 2.30925506e+03f, 2.29660540e+03f, 2.28575621e+03f, 
     2.27648852e+03f, 2.26891805e+03f, 2.26292325e+03f, 2.25849959e+03f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_cp_lowm */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0894%, rel 0.0481% */
 static const f32 tbl[6400] = {
     2.36604936e+03f, 2.37222409e+03f, 2.38216186e+03f, 2.39647519e+03f, 
     2.41615331e+03f, 2.44247488e+03f, 2.47559869e+03f, 2.51614212e+03f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_cp_midm */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 1.57%, rel 0.686% */
 static const f32 tbl[6400] = {
     2.31880978e+03f, 2.30657297e+03f, 2.29615430e+03f, 2.28731254e+03f, 
     2.28013073e+03f, 2.27468088e+03f, 2.27097559e+03f, 2.26915811e+03f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_cp_tht */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0877%, rel 0.0459% */
 static const f32 tbl[6400] = {
     2.37540015e+03f, 2.38378610e+03f, 2.39626711e+03f, 2.41366198e+03f, 
     2.43694936e+03f, 2.46748348e+03f, 2.50533544e+03f, 2.55112291e+03f, 
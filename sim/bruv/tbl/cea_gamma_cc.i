@@ -1,4 +1,8 @@
 /* LUT for cea_gamma_cc */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0105%, rel 0.138% */
 static const f32 tbl[6400] = {
     1.24921227e+00f, 1.24386609e+00f, 1.23836890e+00f, 1.23275786e+00f, 
     1.22700455e+00f, 1.22128748e+00f, 1.21560252e+00f, 1.20997612e+00f, 
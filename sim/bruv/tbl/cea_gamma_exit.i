@@ -1,4 +1,8 @@
 /* LUT for cea_gamma_exit */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0826%, rel 0.764% */
 static const f32 tbl[6400] = {
     1.26337255e+00f, 1.26123625e+00f, 1.25894896e+00f, 1.25650512e+00f, 
     1.25397957e+00f, 1.25131181e+00f, 1.24856413e+00f, 1.24571807e+00f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_gamma_lowm */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.00973%, rel 0.108% */
 static const f32 tbl[6400] = {
     1.25833707e+00f, 1.25405570e+00f, 1.24962046e+00f, 1.24500796e+00f, 
     1.24026678e+00f, 1.23526926e+00f, 1.23014129e+00f, 1.22489285e+00f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_gamma_midm */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0764%, rel 0.717% */
 static const f32 tbl[6400] = {
     1.26406018e+00f, 1.26159543e+00f, 1.25904930e+00f, 1.25635811e+00f, 
     1.25353893e+00f, 1.25063259e+00f, 1.24764534e+00f, 1.24457318e+00f, 
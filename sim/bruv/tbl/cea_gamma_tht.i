@@ -1,4 +1,8 @@
 /* LUT for cea_gamma_tht */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0109%, rel 0.125% */
 static const f32 tbl[6400] = {
     1.25728798e+00f, 1.25285506e+00f, 1.24824079e+00f, 1.24349542e+00f, 
     1.23856371e+00f, 1.23339219e+00f, 1.22811073e+00f, 1.22271971e+00f, 
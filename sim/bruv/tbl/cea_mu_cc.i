@@ -1,4 +1,8 @@
 /* LUT for cea_mu_cc */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0147%, rel 0.0353% */
 static const f32 tbl[6400] = {
     7.10809982e-05f, 7.29431801e-05f, 7.47608744e-05f, 7.65318840e-05f, 
     7.82517335e-05f, 7.99152294e-05f, 8.15266485e-05f, 8.30851266e-05f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_mu_exit */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0798%, rel 0.0622% */
 static const f32 tbl[6400] = {
     5.11980610e-05f, 5.26838751e-05f, 5.41586312e-05f, 5.56238723e-05f, 
     5.70797669e-05f, 5.85256980e-05f, 5.99644599e-05f, 6.13966785e-05f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_mu_lowm */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0137%, rel 0.0303% */
 static const f32 tbl[6400] = {
     6.44281517e-05f, 6.62198168e-05f, 6.79856241e-05f, 6.97246850e-05f, 
     7.14341120e-05f, 7.31100530e-05f, 7.47549479e-05f, 7.63665504e-05f, 
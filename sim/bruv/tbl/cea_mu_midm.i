@@ -1,4 +1,8 @@
 /* LUT for cea_mu_midm */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0496%, rel 0.0402% */
 static const f32 tbl[6400] = {
     5.26467492e-05f, 5.41739563e-05f, 5.56902206e-05f, 5.71966451e-05f, 
     5.86915485e-05f, 6.01765976e-05f, 6.16538396e-05f, 6.31226663e-05f, 
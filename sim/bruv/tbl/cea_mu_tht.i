@@ -1,4 +1,8 @@
 /* LUT for cea_mu_tht */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0149%, rel 0.0336% */
 static const f32 tbl[6400] = {
     6.53789975e-05f, 6.71866077e-05f, 6.89656469e-05f, 7.07163201e-05f, 
     7.24344285e-05f, 7.41161269e-05f, 7.57638728e-05f, 7.73748590e-05f, 
@@ -1,4 +1,8 @@
 /* LUT for cea_rho_cc */
+/* x: [1.0, 5.0] */
+/* y: [1.0, 3.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.0534%, rel 0.104% */
 static const f32 tbl[6400] = {
     1.53440851e-01f, 1.49540396e-01f, 1.45915009e-01f, 1.42537664e-01f, 
     1.39390927e-01f, 1.36449322e-01f, 1.33703825e-01f, 1.31133855e-01f, 
@@ -1,4 +1,8 @@
 /* LUT for ethanol_cp */
+/* x: [250.0, 500.0] */
+/* y: [2.0, 7.0] */
+/* shape: 80x80 */
+/* max error of: abs 1.24%, rel 1.66% */
 static const f32 tbl[6400] = {
     2.12421484e+03f, 2.12418630e+03f, 2.12415800e+03f, 2.12412946e+03f, 
     2.12410124e+03f, 2.12407309e+03f, 2.12404479e+03f, 2.12401673e+03f, 
@@ -1,4 +1,8 @@
 /* LUT for ethanol_mu */
+/* x: [250.0, 500.0] */
+/* y: [2.0, 7.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.161%, rel 0.0925% */
 static const f32 tbl[6400] = {
     3.18970042e-03f, 3.19067347e-03f, 3.19164652e-03f, 3.19261911e-03f, 
     3.19359169e-03f, 3.19456381e-03f, 3.19553569e-03f, 3.19650734e-03f, 
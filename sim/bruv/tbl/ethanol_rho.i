@@ -1,4 +1,8 @@
 /* LUT for ethanol_rho */
+/* x: [250.0, 500.0] */
+/* y: [2.0, 7.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.131%, rel 0.177% */
 static const f32 tbl[6400] = {
     8.27346313e+02f, 8.27389945e+02f, 8.27433535e+02f, 8.27477086e+02f, 
     8.27520635e+02f, 8.27564166e+02f, 8.27607615e+02f, 8.27651125e+02f, 
@@ -1,4 +1,8 @@
 /* LUT for ipa_cp */
+/* x: [250.0, 500.0] */
+/* y: [2.0, 7.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.00939%, rel 0.0072% */
 static const f32 tbl[6400] = {
     2.09240991e+03f, 2.09240991e+03f, 2.09240991e+03f, 2.09240991e+03f, 
     2.09240991e+03f, 2.09240991e+03f, 2.09240991e+03f, 2.09240991e+03f, 
@@ -1,4 +1,8 @@
 /* LUT for ipa_k */
+/* x: [250.0, 500.0] */
+/* y: [2.0, 7.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.000662%, rel 0.00209% */
 static const f32 tbl[6400] = {
     1.45150408e-01f, 1.45173187e-01f, 1.45195965e-01f, 1.45218715e-01f, 
     1.45241453e-01f, 1.45264182e-01f, 1.45286901e-01f, 1.45309590e-01f, 
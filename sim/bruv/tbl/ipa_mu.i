@@ -1,4 +1,8 @@
 /* LUT for ipa_mu */
+/* x: [250.0, 500.0] */
+/* y: [2.0, 7.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.239%, rel 0.222% */
 static const f32 tbl[6400] = {
     1.11433044e-02f, 1.11465200e-02f, 1.11497275e-02f, 1.11529270e-02f, 
     1.11561193e-02f, 1.11593032e-02f, 1.11624807e-02f, 1.11656500e-02f, 
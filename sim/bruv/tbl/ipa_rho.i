@@ -1,4 +1,8 @@
 /* LUT for ipa_rho */
+/* x: [250.0, 500.0] */
+/* y: [2.0, 7.0] */
+/* shape: 80x80 */
+/* max error of: abs 0.366%, rel 0.458% */
 static const f32 tbl[6400] = {
     8.27361633e+02f, 8.27381843e+02f, 8.27402114e+02f, 8.27422323e+02f, 
     8.27442533e+02f, 8.27462742e+02f, 8.27482949e+02f, 8.27503138e+02f, 